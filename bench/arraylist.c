@@ -0,0 +1,296 @@
+
+// Libraries
+#include <stdlib.h>					// To use dynamic memory.
+#include "arraylist.h"
+#include <string.h>
+
+/*
+ * Number of elements an empty list has room for. The room doubles every
+ *  time the list gets full.
+ */
+#define ARRAY_MIN_CAPACITY 8
+
+
+/*
+ * An array list stores its elements one after the other in a single dynamic
+ *  memory block, so walking the list reads consecutive memory instead of
+ *  following pointers. The point of view is the position of the element we
+ *  are visiting. When the POV is equal to the size, it is after the last
+ *  element.
+ *
+ *                              Point of View
+ *            +---+---+---+---+---+---+---+---+
+ *  elements  | 1 | 2 | 3 | 4 |   |   |   |   |    capacity = 8
+ *            +---+---+---+---+---+---+---+---+
+ *                      ^           ^
+ *                     pov = 2     size = 4
+ *
+ * Adding or removing at the POV has to shift the elements after it, but
+ *  there is no node to allocate or free for each element.
+ */
+struct array_t {
+	int error;			// Error code to keep track of failing operations;
+	Element * elements;	// Array with the elements;
+	int size;			// Number of elements stored;
+	int capacity;		// Number of elements the array has room for;
+	int pov;			// Position of the point of view;
+};
+
+
+/****************************************************************************
+ *
+ * @Objective: Creates an empty array list.
+ *			   If the list fails to get its memory, it will set the error
+ *				code to LIST_ERROR_MALLOC.
+ *
+ * @Parameters: ---
+ * @Return: An empty array list
+ *
+ ****************************************************************************/
+ArrayList ARRAYLIST_create () {
+	ArrayList list = (ArrayList) malloc (sizeof(struct array_t));
+
+	list->size = 0;
+	list->pov = 0;
+	list->elements = (Element*) malloc (sizeof(Element) * ARRAY_MIN_CAPACITY);
+	if (NULL != list->elements) {
+		list->capacity = ARRAY_MIN_CAPACITY;
+		list->error = LIST_NO_ERROR;
+	}
+	else {
+		list->capacity = 0;
+		list->error = LIST_ERROR_MALLOC;
+	}
+
+	return list;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Inserts the specified element in this list before the element
+ *			    who is the current point of view. Shifts the point of view
+ *				element (if any) and any subsequent elements to the right.
+ *			   If the list fails to grow, it will set the error code to
+ *				LIST_ERROR_MALLOC.
+ *
+ * @Parameters: (in/out) list    = the array list where to add the new element
+ *				(in)     element = the element to add to the list
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	ARRAYLIST_add (ArrayList list, Element element) {
+	Element* elements = NULL;
+	int capacity = 0;
+
+	// 1- Make room for one more element if the array is full.
+	if (list->size == list->capacity) {
+		capacity = (0 == list->capacity) ? ARRAY_MIN_CAPACITY : list->capacity * 2;
+		elements = (Element*) realloc (list->elements, sizeof(Element) * capacity);
+		if (NULL != elements) {
+			list->elements = elements;
+			list->capacity = capacity;
+		}
+	}
+
+	if (list->size < list->capacity) {
+		// 2- Shift the POV and the elements after it one position right.
+		memmove(&(list->elements[list->pov + 1]), &(list->elements[list->pov]), sizeof(Element) * (list->size - list->pov));
+		// 3- Store the element and move the POV after it, as the linked
+		//    list does.
+		list->elements[list->pov] = element;
+		list->size++;
+		list->pov++;
+		list->error = LIST_NO_ERROR;
+	}
+	else {
+		list->error = LIST_ERROR_MALLOC;
+	}
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Removes the element currently at the point of view in this
+ *				list. Shifts any subsequent elements to the left.
+ *			   This operation will fail if the POV is after the last valid
+ *				element of the list, setting the error code to LIST_ERROR_END.
+ *
+ * @Parameters: (in/out) list = the array list where to remove the element
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	ARRAYLIST_remove (ArrayList list) {
+	if (ARRAYLIST_isAtEnd (list)) {
+		list->error = LIST_ERROR_END;
+	}
+	else {
+		// Shift the elements after the POV one position left.
+		memmove(&(list->elements[list->pov]), &(list->elements[list->pov + 1]), sizeof(Element) * (list->size - list->pov - 1));
+		list->size--;
+		list->error = LIST_NO_ERROR;
+	}
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns the element currently at the point of view in this list.
+ *			   This operation will fail if the POV is after the last valid
+ *				element of the list, setting the error code to LIST_ERROR_END.
+ *
+ * @Parameters: (in/out) list = the array list where to get the element.
+ * @Return: The element at the POV
+ *
+ ****************************************************************************/
+Element	ARRAYLIST_get (ArrayList list) {
+	Element element;
+
+	if (ARRAYLIST_isAtEnd (list)) {
+		list->error = LIST_ERROR_END;
+	}
+	else {
+		element = list->elements[list->pov];
+		list->error = LIST_NO_ERROR;
+	}
+
+	return element;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns a pointer to the element currently at the point of
+ *				view in this list, without copying it. The pointer is only
+ *				valid until the list is modified.
+ *			   This operation will fail if the POV is after the last valid
+ *				element of the list, returning NULL and setting the error
+ *				code to LIST_ERROR_END.
+ *
+ * @Parameters: (in/out) list = the array list where to get the element.
+ * @Return: A pointer to the element at the POV or NULL
+ *
+ ****************************************************************************/
+const Element* ARRAYLIST_peek (ArrayList list) {
+	const Element* element = NULL;
+
+	if (ARRAYLIST_isAtEnd (list)) {
+		list->error = LIST_ERROR_END;
+	}
+	else {
+		element = &(list->elements[list->pov]);
+		list->error = LIST_NO_ERROR;
+	}
+
+	return element;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns true (!0) if this list contains no elements.
+ *
+ * @Parameters: (in)     list = the array list to check
+ * @Return: true (!0) if this list contains no elements, false (0) otherwise
+ *
+ ****************************************************************************/
+int		ARRAYLIST_isEmpty (ArrayList list) {
+	return 0 == list->size;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns the number of elements in this list.
+ *
+ * @Parameters: (in)     list = the array list to check
+ * @Return: The number of elements in the list
+ *
+ ****************************************************************************/
+int		ARRAYLIST_size (ArrayList list) {
+	return list->size;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Moves the point of view to the first element in the list.
+ *
+ * @Parameters: (in/out) list = the array list to move the POV.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	ARRAYLIST_goToHead (ArrayList list) {
+	list->pov = 0;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Moves the point of view to the next element in the list.
+ *				If the POV is after the last element in the list (or when
+ *				the list is empty), this function will set the list's error
+ *				to LIST_ERROR_END.
+ *
+ * @Parameters: (in/out) list = the array list to move the POV.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	ARRAYLIST_next (ArrayList list) {
+	if (ARRAYLIST_isAtEnd (list)) {
+		list->error = LIST_ERROR_END;
+	}
+	else {
+		list->pov++;
+		list->error = LIST_NO_ERROR;
+	}
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns true (!0) if the POV is after the last element in the
+ *				list.
+ *
+ * @Parameters: (in)     list = the array list to check.
+ * @Return: true (!0) if the POV is after the last element in the list
+ *
+ ****************************************************************************/
+int		ARRAYLIST_isAtEnd (ArrayList list) {
+	return list->pov >= list->size;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Removes all the elements from the list and frees any dynamic
+ *				memory block the list was using. The list must be created
+ *				again before usage.
+ *
+ * @Parameters: (in/out) list = the array list to destroy.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	ARRAYLIST_destroy (ArrayList* list) {
+	// All the elements live in a single block, so one free is enough.
+	free((*list)->elements);
+	(*list)->elements = NULL;
+
+	free(*list);
+	*list = NULL;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: This function returns the error code provided by the last
+ *				operation run. The operations that update the error code are:
+ *				Create, Add, Remove, Get, Peek and Next.
+ *
+ * @Parameters: (in)     list = the array list to check.
+ * @Return: an error code from the list of constants defined.
+ *
+ ****************************************************************************/
+int		ARRAYLIST_getErrorCode (ArrayList list) {
+	return list->error;
+}
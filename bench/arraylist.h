@@ -0,0 +1,201 @@
+/****************************************************************************
+ *
+ * @Objective: Array list data structure implementation
+ *             An array list is a linear data structure, in which the
+ *             elements are stored at contiguous memory locations, with the
+ *             same "point of view" operations as the linked list. It is
+ *             only the contiguous baseline of bench/roster_bench: the
+ *             rosters of the program are linked lists.
+ * @Author/s:  Pau Díaz Cuesta
+ *
+ * @Creation date: 17/10/2026
+ * @Last modification date: 17/10/2026
+ *
+ ****************************************************************************/
+
+// Define guard to prevent compilation problems if we add the module more
+//  than once in the project.
+#ifndef _ARRAYLIST_H_
+#define _ARRAYLIST_H_
+
+// The element type and the error codes are the ones of the linked list, so
+//  that both lists can be used interchangeably.
+#include "linkedlist.h"
+
+
+// Data types
+typedef struct array_t* ArrayList;
+
+
+// Procedures & Functions
+
+/****************************************************************************
+ *
+ * @Objective: Creates an empty array list.
+ *			   If the list fails to get its memory, it will set the error
+ *				code to LIST_ERROR_MALLOC.
+ *
+ * @Parameters: ---
+ * @Return: An empty array list
+ *
+ ****************************************************************************/
+ArrayList ARRAYLIST_create ();
+
+
+/****************************************************************************
+ *
+ * @Objective: Inserts the specified element in this list before the element
+ *			    who is the current point of view. Shifts the point of view
+ *				element (if any) and any subsequent elements to the right.
+ *			   If the list fails to grow, it will set the error code to
+ *				LIST_ERROR_MALLOC.
+ *
+ * @Parameters: (in/out) list    = the array list where to add the new element
+ *				(in)     element = the element to add to the list
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	ARRAYLIST_add (ArrayList list, Element element);
+
+
+/****************************************************************************
+ *
+ * @Objective: Removes the element currently at the point of view in this
+ *				list. Shifts any subsequent elements to the left.
+ *			   This operation will fail if the POV is after the last valid
+ *				element of the list, setting the error code to LIST_ERROR_END.
+ *
+ * @Parameters: (in/out) list = the array list where to remove the element
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	ARRAYLIST_remove (ArrayList list);
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns the element currently at the point of view in this list.
+ *			   This operation will fail if the POV is after the last valid
+ *				element of the list, setting the error code to LIST_ERROR_END.
+ *
+ * @Parameters: (in/out) list = the array list where to get the element.
+ * @Return: The element at the POV
+ *
+ ****************************************************************************/
+Element	ARRAYLIST_get (ArrayList list);
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns a pointer to the element currently at the point of
+ *				view in this list, without copying it. The pointer is only
+ *				valid until the list is modified.
+ *			   This operation will fail if the POV is after the last valid
+ *				element of the list, returning NULL and setting the error
+ *				code to LIST_ERROR_END.
+ *
+ * @Parameters: (in/out) list = the array list where to get the element.
+ * @Return: A pointer to the element at the POV or NULL
+ *
+ ****************************************************************************/
+const Element* ARRAYLIST_peek (ArrayList list);
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns true (!0) if this list contains no elements.
+ *
+ * @Parameters: (in)     list = the array list to check
+ * @Return: true (!0) if this list contains no elements, false (0) otherwise
+ *
+ ****************************************************************************/
+int		ARRAYLIST_isEmpty (ArrayList list);
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns the number of elements in this list.
+ *
+ * @Parameters: (in)     list = the array list to check
+ * @Return: The number of elements in the list
+ *
+ ****************************************************************************/
+int		ARRAYLIST_size (ArrayList list);
+
+
+/****************************************************************************
+ *
+ * @Objective: Moves the point of view to the first element in the list.
+ *
+ * @Parameters: (in/out) list = the array list to move the POV.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	ARRAYLIST_goToHead (ArrayList list);
+
+
+/****************************************************************************
+ *
+ * @Objective: Moves the point of view to the next element in the list.
+ *				If the POV is after the last element in the list (or when
+ *				the list is empty), this function will set the list's error
+ *				to LIST_ERROR_END.
+ *
+ * @Parameters: (in/out) list = the array list to move the POV.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	ARRAYLIST_next (ArrayList list);
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns true (!0) if the POV is after the last element in the
+ *				list.
+ *
+ * @Parameters: (in)     list = the array list to check.
+ * @Return: true (!0) if the POV is after the last element in the list
+ *
+ ****************************************************************************/
+int		ARRAYLIST_isAtEnd (ArrayList list);
+
+
+/****************************************************************************
+ *
+ * @Objective: Removes all the elements from the list and frees any dynamic
+ *				memory block the list was using. The list must be created
+ *				again before usage.
+ *
+ * @Parameters: (in/out) list = the array list to destroy.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	ARRAYLIST_destroy (ArrayList* list);
+
+
+/****************************************************************************
+ *
+ * @Objective: This function returns the error code provided by the last
+ *				operation run. The operations that update the error code are:
+ *				Create, Add, Remove, Get, Peek and Next.
+ *
+ * @Parameters: (in)     list = the array list to check.
+ * @Return: an error code from the list of constants defined.
+ *
+ ****************************************************************************/
+int		ARRAYLIST_getErrorCode (ArrayList list);
+
+
+/****************************************************************************
+ *
+ * @Objective: Walks the whole list from its first element, leaving in the
+ *				pointer "element" (const Element*) each one of the elements,
+ *				as LINKEDLIST_FOREACH_READ does with an iterator. The POV of
+ *				the list is moved on every step.
+ *
+ ****************************************************************************/
+#define ARRAYLIST_FOREACH(list, element) \
+	for (ARRAYLIST_goToHead(list); NULL != ((element) = ARRAYLIST_peek(list)); ARRAYLIST_next(list))
+
+
+#endif
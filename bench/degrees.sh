@@ -0,0 +1,43 @@
+#!/bin/sh
+#
+# Load time against the number of degrees.
+#  Generates a classrooms file with N degrees (2 classrooms each) and a
+#  students file with STUDENTS students spread evenly among the degrees,
+#  then times how long ./final_output takes to load both files and exit.
+#
+# Usage: sh bench/degrees.sh [STUDENTS] [DEGREES...]
+#  (set BIN to time another build of the program)
+
+BIN=${BIN:-./final_output}
+STUDENTS=${1:-200000}
+[ $# -gt 0 ] && shift
+DEGREES=${*:-"10 100 1000 5000 10000"}
+TMP=${TMPDIR:-/tmp}/classrooms_bench.$$
+
+mkdir -p "$TMP"
+trap 'rm -rf "$TMP"' EXIT
+
+printf "%10s %10s %12s\n" "degrees" "students" "load (ms)"
+for n in $DEGREES; do
+	awk -v n="$n" 'BEGIN {
+		print n
+		for (i = 0; i < n; i++) {
+			print "2 Degree " i
+			print "R" i ".1"
+			print "R" i ".2"
+		}
+	}' > "$TMP/class"
+	awk -v n="$n" -v s="$STUDENTS" 'BEGIN {
+		for (i = 0; i < s; i++) {
+			print "Student" i ", Degree " (i % n)
+			printf "login%d", i
+			if (i < s - 1) print ""
+		}
+	}' > "$TMP/stus"
+
+	start=$(date +%s%N)
+	printf "%s\n%s\n4\n" "$TMP/class" "$TMP/stus" | $BIN > /dev/null
+	end=$(date +%s%N)
+
+	printf "%10d %10d %12d\n" "$n" "$STUDENTS" $(( (end - start) / 1000000 ))
+done
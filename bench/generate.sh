@@ -0,0 +1,76 @@
+#!/bin/sh
+#
+# Synthetic data for the benchmarks.
+#  Writes, in the directory DIR, a classrooms file ("class") and a students
+#  file ("stus") in the same format as class_1 and stus_1, plus two files of
+#  moves of random students to random classrooms of their degree: "moves",
+#  a script of move commands, and "bulk", a bulk moves file. A move fails if
+#  the student is already in that classroom, as it happens with real users.
+#
+#  The students are spread among the degrees with a Zipf distribution: the
+#  degree k (from 0) gets a share proportional to 1 / (k + 1)^SKEW, so
+#  SKEW=0 spreads them evenly and SKEW=1 gives the first degree twice the
+#  students of the second one and ten times those of the tenth one. The same
+#  SEED always writes the same files.
+#
+# Usage: sh bench/generate.sh DIR
+#  (set STUDENTS, DEGREES, CLASSROOMS per degree, CAPACITY of each classroom
+#   (0 for no limit), SKEW, MOVES and SEED to change the data)
+
+DIR=${1:?"Usage: sh bench/generate.sh DIR"}
+STUDENTS=${STUDENTS:-100000}
+DEGREES=${DEGREES:-100}
+CLASSROOMS=${CLASSROOMS:-4}
+CAPACITY=${CAPACITY:-0}
+SKEW=${SKEW:-0}
+MOVES=${MOVES:-10000}
+SEED=${SEED:-1}
+
+mkdir -p "$DIR" || exit 1
+
+awk -v n="$DEGREES" -v c="$CLASSROOMS" -v cap="$CAPACITY" 'BEGIN {
+	print n
+	for (i = 0; i < n; i++) {
+		print c " Degree " i
+		for (j = 1; j <= c; j++) {
+			if (cap > 0) print "R" i "." j " " cap
+			else print "R" i "." j
+		}
+	}
+}' > "$DIR/class"
+
+awk -v n="$DEGREES" -v c="$CLASSROOMS" -v s="$STUDENTS" -v skew="$SKEW" -v m="$MOVES" \
+	-v seed="$SEED" -v dir="$DIR" 'BEGIN {
+	srand(seed)
+
+	# Cumulative share of the degrees, to choose one with a binary search.
+	total = 0
+	for (k = 0; k < n; k++) {
+		total += 1 / (k + 1) ^ skew
+		cumulative[k] = total
+	}
+
+	for (i = 0; i < s; i++) {
+		r = rand() * total
+		lo = 0
+		hi = n - 1
+		while (lo < hi) {
+			mid = int((lo + hi) / 2)
+			if (cumulative[mid] < r) lo = mid + 1
+			else hi = mid
+		}
+		degree[i] = lo
+		print "Student" i ", Degree " lo > (dir "/stus")
+		if (i < s - 1) print "login" i > (dir "/stus")
+		else printf "login%d", i > (dir "/stus")
+	}
+
+	for (i = 0; i < m && s > 0; i++) {
+		j = int(rand() * s)
+		to = 1 + int(rand() * c)
+		print "move login" j " " to " Degree " degree[j] > (dir "/moves")
+		print "login" j " R" degree[j] "." to > (dir "/bulk")
+	}
+	print "exit" > (dir "/moves")
+}'
+: >> "$DIR/bulk"
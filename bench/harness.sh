@@ -0,0 +1,82 @@
+#!/bin/sh
+#
+# Time of each kind of operation against the number of students.
+#  For every number of students, generates the data with bench/generate.sh
+#  and runs ./final_output in the non-interactive mode once per phase:
+#
+#   load     loading both files (every other phase also loads them, so its
+#            load time is subtracted)
+#   summary  SUMMARIES summary commands
+#   show     a show command for every degree
+#   move     MOVES move commands of random students
+#   bulk     a bulk move of MOVES random students
+#
+#  and reports the throughput and the peak memory (resident set size) of
+#  every phase, which ./final_output -m writes to stderr. Every phase runs
+#  RUNS times and the fastest run is kept, so that the subtraction of the
+#  load time is less noisy.
+#
+# Usage: sh bench/harness.sh [STUDENTS...]
+#  (set BIN to time another build of the program, RUNS to change the number
+#   of runs; DEGREES, CLASSROOMS, CAPACITY, SKEW, MOVES and SEED are passed
+#   to bench/generate.sh)
+
+BIN=${BIN:-./final_output}
+SIZES=${*:-"100000 1000000"}
+DEGREES=${DEGREES:-100}
+SUMMARIES=${SUMMARIES:-1000}
+RUNS=${RUNS:-3}
+TMP=${TMPDIR:-/tmp}/classrooms_bench.$$
+
+export DEGREES
+mkdir -p "$TMP"
+trap 'rm -rf "$TMP"' EXIT
+
+# Runs the program RUNS times with a script of commands and prints the
+#  milliseconds of the fastest run and the peak memory in KB.
+run () {
+	best=0
+	r=0
+	while [ $r -lt "$RUNS" ]; do
+		start=$(date +%s%N)
+		$BIN -m "$TMP/class" "$TMP/stus" "$1" > /dev/null 2> "$TMP/metrics"
+		end=$(date +%s%N)
+		ms=$(( (end - start) / 1000000 ))
+		[ $best -eq 0 ] || [ $ms -lt $best ] && best=$ms
+		r=$((r + 1))
+	done
+	echo $best $(awk '/^peak RSS/ { print $NF }' "$TMP/metrics")
+}
+
+# Prints a line of the report. The time of the phase does not include the
+#  load time.
+report () {
+	awk -v n="$1" -v phase="$2" -v ops="$3" -v unit="$4" -v ms="$5" -v load="$6" -v kb="$7" 'BEGIN {
+		if (phase != "load") ms -= load
+		if (ms < 1) ms = 1
+		printf "%10d %-8s %10d %12d %14.0f %-9s %10.1f\n", n, phase, ops, ms, ops * 1000 / ms, unit, kb / 1024
+	}'
+}
+
+printf "%10s %-8s %10s %12s %14s %-9s %10s\n" "students" "phase" "ops" "time (ms)" "throughput" "" "RSS (MB)"
+for n in $SIZES; do
+	STUDENTS=$n sh "$(dirname "$0")/generate.sh" "$TMP" || exit 1
+
+	echo exit > "$TMP/load"
+	awk -v r="$SUMMARIES" 'BEGIN { for (i = 0; i < r; i++) print "summary"; print "exit" }' > "$TMP/summary"
+	awk -v d="$DEGREES" 'BEGIN { for (i = 0; i < d; i++) print "show Degree " i; print "exit" }' > "$TMP/show"
+	printf "bulkmove %s\nexit\n" "$TMP/bulk" > "$TMP/bulkmove"
+	moves=$(grep -c "^move" "$TMP/moves")
+
+	set -- $(run "$TMP/load")
+	load=$1
+	report "$n" load "$n" students/s "$1" 0 "$2"
+	set -- $(run "$TMP/summary")
+	report "$n" summary "$SUMMARIES" ops/s "$1" "$load" "$2"
+	set -- $(run "$TMP/show")
+	report "$n" show "$n" students/s "$1" "$load" "$2"
+	set -- $(run "$TMP/moves")
+	report "$n" move "$moves" moves/s "$1" "$load" "$2"
+	set -- $(run "$TMP/bulkmove")
+	report "$n" bulk "$moves" moves/s "$1" "$load" "$2"
+done
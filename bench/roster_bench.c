@@ -0,0 +1,176 @@
+/****************************************************************************
+ *
+ * @Objective: Microbenchmark of the roster containers: LinkedList (one
+ *             malloc per node), LinkedList with a NodePool and ArrayList.
+ *             For every roster size it measures a full traversal, inserting
+ *             at the cursor and removing at the cursor, with the cursor in
+ *             the middle of the roster. The cursor of the linked lists is
+ *             an iterator and the one of the array list is its POV.
+ *
+ *             Usage: ./bench/roster_bench [max_students]
+ *
+ ****************************************************************************/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "linkedlist.h"
+#include "arraylist.h"
+
+// Number of elements visited when timing the traversals.
+#define VISITS 10000000
+
+// Sum of the login handles visited, so that the traversals cannot be
+//  optimised away.
+static volatile long sink = 0;
+
+
+static double now () {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static Student makeStudent (int i) {
+	Student student;
+
+	// The texts live in the string table, the roster only stores handles.
+	student.name = 2 * i;
+	student.login = 2 * i + 1;
+	return student;
+}
+
+static int cursorOps (int size) {
+	int ops = size <= 10000 ? 1000 : 100;
+
+	// Never remove more elements than the roster has after the cursor.
+	return ops < size ? ops : size;
+}
+
+
+/*
+ * LinkedList (pool == NULL means one malloc per node).
+ */
+static void benchLinked (int size, NodePool pool, const Student extra[], double result[3]) {
+	LinkedList list = NULL == pool ? LINKEDLIST_create() : LINKEDLIST_createWithPool(pool);
+	ListIterator cursor;
+	const Student* student = NULL;
+	int ops = cursorOps(size);
+	int rounds = VISITS / size;
+	int i = 0, r = 0;
+	double start = 0;
+
+	for (i = 0; i < size; i++) {
+		LINKEDLIST_append(list, makeStudent(i));
+	}
+
+	start = now();
+	for (r = 0; r < rounds; r++) {
+		LINKEDLIST_FOREACH_READ(list, cursor, student) {
+			sink += student->login;
+		}
+	}
+	result[0] = (now() - start) / ((double) rounds * size);
+
+	LINKEDLIST_iterate(list, &cursor);
+	for (i = 0; i < size / 2; i++) {
+		LINKEDLIST_iteratorNext(&cursor);
+	}
+	start = now();
+	for (i = 0; i < ops; i++) {
+		LINKEDLIST_iteratorInsert(&cursor, extra[i]);
+	}
+	result[1] = (now() - start) / ops;
+
+	LINKEDLIST_iterate(list, &cursor);
+	for (i = 0; i < size / 2; i++) {
+		LINKEDLIST_iteratorNext(&cursor);
+	}
+	start = now();
+	for (i = 0; i < ops; i++) {
+		LINKEDLIST_iteratorRemove(&cursor);
+	}
+	result[2] = (now() - start) / ops;
+
+	LINKEDLIST_destroy(&list);
+}
+
+
+/*
+ * ArrayList.
+ */
+static void benchArray (int size, const Student extra[], double result[3]) {
+	ArrayList list = ARRAYLIST_create();
+	const Student* student = NULL;
+	int ops = cursorOps(size);
+	int rounds = VISITS / size;
+	int i = 0, r = 0;
+	double start = 0;
+
+	for (i = 0; i < size; i++) {
+		ARRAYLIST_add(list, makeStudent(i));
+	}
+
+	start = now();
+	for (r = 0; r < rounds; r++) {
+		ARRAYLIST_FOREACH(list, student) {
+			sink += student->login;
+		}
+	}
+	result[0] = (now() - start) / ((double) rounds * size);
+
+	ARRAYLIST_goToHead(list);
+	for (i = 0; i < size / 2; i++) {
+		ARRAYLIST_next(list);
+	}
+	start = now();
+	for (i = 0; i < ops; i++) {
+		ARRAYLIST_add(list, extra[i]);
+	}
+	result[1] = (now() - start) / ops;
+
+	ARRAYLIST_goToHead(list);
+	for (i = 0; i < size / 2; i++) {
+		ARRAYLIST_next(list);
+	}
+	start = now();
+	for (i = 0; i < ops; i++) {
+		ARRAYLIST_remove(list);
+	}
+	result[2] = (now() - start) / ops;
+
+	ARRAYLIST_destroy(&list);
+}
+
+
+int main (int argc, char* argv[]) {
+	const char* ops[3] = {"traverse", "insert", "remove"};
+	int max = argc > 1 ? atoi(argv[1]) : 1000000;
+	double linked[3], pooled[3], array[3];
+	NodePool pool = NULL;
+	Student extra[1000];
+	int size = 0, op = 0, i = 0;
+
+	// The students inserted at the cursor are built before timing.
+	for (i = 0; i < 1000; i++) {
+		extra[i] = makeStudent(-i);
+	}
+
+	printf("%10s %10s %14s %14s %14s\n", "students", "op", "linked ns/op", "pooled ns/op", "array ns/op");
+	for (size = 10; size <= max; size *= 10) {
+		pool = LINKEDLIST_createPool();
+		benchLinked(size, NULL, extra, linked);
+		benchLinked(size, pool, extra, pooled);
+		benchArray(size, extra, array);
+		LINKEDLIST_destroyPool(&pool);
+
+		for (op = 0; op < 3; op++) {
+			printf("%10d %10s %14.1f %14.1f %14.1f\n", size, ops[op], linked[op], pooled[op], array[op]);
+		}
+	}
+
+	return 0;
+}
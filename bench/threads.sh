@@ -0,0 +1,84 @@
+#!/bin/sh
+#
+# Load time against the number of threads reading the students file.
+#  Generates a classrooms file with DEGREES degrees and a students file with
+#  STUDENTS students, then times how long ./final_output -t N takes to load
+#  both files and exit. The rosters of every run must be the same as the
+#  ones of the sequential run (-t 1).
+#  The split of the lines into fields runs in parallel by chunks of the
+#  file, and the classroom assignment and the linking of the nodes by groups
+#  of degrees (each thread with its own node pool). Interning the texts and
+#  filling the login index stay sequential, so the speedup is bounded by
+#  that part (and by the number of CPUs and of degrees). Every
+#  number of threads runs RUNS times after a warm-up run (which brings the
+#  files to the page cache) and the fastest run is kept.
+#
+# Usage: sh bench/threads.sh [STUDENTS] [THREADS...]
+#  (set BIN to time another build of the program, DEGREES to change the
+#   number of degrees, RUNS to change the number of runs)
+
+BIN=${BIN:-./final_output}
+STUDENTS=${1:-1000000}
+[ $# -gt 0 ] && shift
+THREADS=${*:-"1 2 4 8"}
+DEGREES=${DEGREES:-100}
+RUNS=${RUNS:-3}
+TMP=${TMPDIR:-/tmp}/classrooms_bench.$$
+
+mkdir -p "$TMP"
+trap 'rm -rf "$TMP"' EXIT
+
+awk -v n="$DEGREES" 'BEGIN {
+	print n
+	for (i = 0; i < n; i++) {
+		print "2 Degree " i
+		print "R" i ".1"
+		print "R" i ".2"
+	}
+}' > "$TMP/class"
+awk -v n="$DEGREES" -v s="$STUDENTS" 'BEGIN {
+	for (i = 0; i < s; i++) {
+		print "Student" i ", Degree " (i % n)
+		printf "login%d", i
+		if (i < s - 1) print ""
+	}
+}' > "$TMP/stus"
+
+# Script that loads the files, shows every degree and exits, to compare the
+#  rosters of each run.
+{
+	printf "%s\n%s\n1\n" "$TMP/class" "$TMP/stus"
+	i=0
+	while [ $i -lt "$DEGREES" ]; do
+		printf "2\nDegree %d\n" $i
+		i=$((i + 1))
+	done
+	printf "4\n"
+} > "$TMP/show"
+
+printf "%s\n%s\n4\n" "$TMP/class" "$TMP/stus" > "$TMP/load"
+$BIN < "$TMP/load" > /dev/null
+
+printf "%s CPUs\n" "$(getconf _NPROCESSORS_ONLN)"
+printf "%10s %10s %12s %10s %10s\n" "threads" "students" "load (ms)" "speedup" "rosters"
+base=0
+for t in $THREADS; do
+	ms=0
+	r=0
+	while [ $r -lt "$RUNS" ]; do
+		start=$(date +%s%N)
+		$BIN -t "$t" < "$TMP/load" > /dev/null
+		end=$(date +%s%N)
+		run=$(( (end - start) / 1000000 ))
+		[ $ms -eq 0 ] || [ $run -lt $ms ] && ms=$run
+		r=$((r + 1))
+	done
+	[ $base -eq 0 ] && base=$ms
+
+	$BIN -t "$t" < "$TMP/show" > "$TMP/out.$t"
+	[ -f "$TMP/out.ref" ] || $BIN -t 1 < "$TMP/show" > "$TMP/out.ref"
+	if cmp -s "$TMP/out.ref" "$TMP/out.$t"; then same=same; else same=DIFFERENT; fi
+
+	printf "%10d %10d %12d %10s %10s\n" "$t" "$STUDENTS" $ms \
+		"$(awk -v b=$base -v m=$ms 'BEGIN { printf "%.2fx", m ? b / m : 0 }')" "$same"
+done
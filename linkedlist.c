@@ -1,20 +1,49 @@
 // Libraries
 #include <stdlib.h>					// To use dynamic memory.
 #include "linkedlist.h"
+#include "metrics.h"				// Counters of the operations (only with ENABLE_METRICS).
 #include <stdio.h>
 #include <string.h>
 
+// The node (struct _Node) is declared in linkedlist.h, so that the read
+//  path of the iterators can be inlined in the walks of its users.
+typedef struct _Node Node;
+
+
+/*
+ * Number of nodes carved from each memory block of a node pool.
+ */
+#define POOL_BLOCK_NODES 1024
+
+/*
+ * A Block is one of the big memory blocks requested by a node pool. The
+ *  blocks of a pool are chained so that they can be freed all at once.
+ */
+typedef struct _Block {
+	struct _Block * next;
+	Node nodes[POOL_BLOCK_NODES];
+} Block;
+
 /*
- * Node is a recursive structure that will contain each one of the elements.
- * A node has two main fields, the element to store and a pointer to the next
- *  node in the Linear Data Structure.
- * The structure is recursively defined (a Node has a pointer to another node),
- *  so we need to define a new type (typedef) from a structure (struct _Node).
+ * A node pool hands out nodes from its last block until it is exhausted,
+ *  then requests a new block. The nodes given back by the lists are kept
+ *  in a free list (linked through their own next field) and are reused
+ *  before carving new ones.
+ *
+ *         +---+     +------------------+     +------------------+
+ *  blocks | o-|---->| o | 1 | 2 | ... |---->| o | 1 | 2 | ... |---->NULL
+ *         +---+     +------------------+     +------------------+
+ *   used  | n |       Nodes carved from the first block (the newest).
+ *         +---+
+ *   free  | o-|----> Node ----> Node ----> NULL
+ *         +---+
  */
-typedef struct _Node {		
-	Element element;
-	struct _Node * next;
-} Node;
+struct pool_t {
+	Block * blocks;		// Chain of blocks, the newest one first;
+	int used;			// Nodes already carved from the newest block;
+	Node * free;		// Nodes given back by the lists, ready to reuse;
+	struct pool_t * shared;	// Pool that will own the nodes (local pools) or NULL;
+};
 
 
 
@@ -59,14 +88,276 @@ typedef struct _Node {
  *                    |   | o-|-->| 1 | o-|---> | 2 | o-|---> | 3 |NULL| 
  *                    +---+---+   +---+---+     +---+---+     +---+----+
  *
+ * The list also keeps a pointer to its last node ("tail") and its number of
+ *  elements, updated by every operation that links or unlinks a node, so
+ *  that the size and the append at the end do not need to walk the list.
+ *
  */
 struct list_t {
 	int error;			// Error code to keep track of failing operations;
 	Node * head;	 	// Head/First element or Phantom node;
 	Node * previous; 	// Previous node before the point of view;
+	Node * tail;		// Last node (the phantom node if the list is empty);
+	int size;			// Number of elements in the list;
+	NodePool pool;		// Node pool where the nodes come from (or NULL);
 };
 
 
+/**************************************************************************** 
+ *
+ * @Objective: Requests a new block for the node pool and links it as the
+ *				first block. The nodes that were never carved from the old
+ *				first block go to the free list so that they are not lost.
+ *
+ * @Parameters: (in/out) pool = the node pool that needs a new block
+ * @Return: true (!0) if the block could be requested, false (0) otherwise
+ *
+ ****************************************************************************/
+static int newBlock (NodePool pool) {
+	Block* block = (Block*) malloc (sizeof(Block));
+
+	if (NULL != block) {
+		// Give the rest of the old block to the free list.
+		while (NULL != pool->blocks && POOL_BLOCK_NODES != pool->used) {
+			pool->blocks->nodes[pool->used].next = pool->free;
+			pool->free = &(pool->blocks->nodes[pool->used]);
+			pool->used++;
+		}
+		block->next = pool->blocks;
+		pool->blocks = block;
+		pool->used = 0;
+	}
+
+	return NULL != block;
+}
+
+
+/*
+ * Returns the pool that owns the nodes of a list in the end: the nodes of a
+ *  local pool are given to its shared pool.
+ */
+static NodePool ownerPool (NodePool pool) {
+	return (NULL != pool && NULL != pool->shared) ? pool->shared : pool;
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Gets the memory for a new node. If the list has a node pool
+ *				the node is taken from the pool, otherwise it is requested
+ *				with malloc.
+ *
+ * @Parameters: (in/out) list = the linked list that will store the node
+ * @Return: The new node, or NULL if there was no memory available
+ *
+ ****************************************************************************/
+static Node* allocNode (LinkedList list) {
+	NodePool pool = list->pool;
+	Node* node = NULL;
+
+	METRICS_COUNT(METRIC_LIST_NODES, 1);
+	if (NULL == pool) {
+		node = (Node*) malloc (sizeof(Node));
+	}
+	else if (NULL != pool->free) {
+		// Reuse a node given back by a list.
+		node = pool->free;
+		pool->free = node->next;
+	}
+	else if ((NULL != pool->blocks && POOL_BLOCK_NODES != pool->used) || newBlock(pool)) {
+		// Carve the next node of the newest block.
+		node = &(pool->blocks->nodes[pool->used]);
+		pool->used++;
+	}
+
+	return node;
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Carves a run of consecutive nodes from the node pool. If the
+ *				newest block has no room for the whole run, a new block is
+ *				requested. A run is never longer than a block, so fewer nodes
+ *				than wanted can be returned.
+ *
+ * @Parameters: (in/out) pool   = the node pool where to take the nodes from
+ *				(in)     wanted = number of nodes wanted
+ *				(out)    got    = number of nodes returned
+ * @Return: The first node of the run, or NULL if there was no memory
+ *
+ ****************************************************************************/
+static Node* allocRun (NodePool pool, int wanted, int* got) {
+	Node* run = NULL;
+
+	if (wanted > POOL_BLOCK_NODES) {
+		wanted = POOL_BLOCK_NODES;
+	}
+	*got = 0;
+
+	if ((NULL != pool->blocks && pool->used + wanted <= POOL_BLOCK_NODES) || newBlock(pool)) {
+		run = &(pool->blocks->nodes[pool->used]);
+		pool->used += wanted;
+		*got = wanted;
+		METRICS_COUNT(METRIC_LIST_NODES, wanted);
+	}
+
+	return run;
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Gives back the memory of a node. If the list has a node pool
+ *				the node goes to the pool's free list, otherwise it is freed.
+ *
+ * @Parameters: (in/out) list = the linked list that stored the node
+ *				(in)     node = the node to give back
+ * @Return: ---
+ *
+ ****************************************************************************/
+static void freeNode (LinkedList list, Node* node) {
+	if (NULL == list->pool) {
+		free(node);
+	}
+	else {
+		node->next = list->pool->free;
+		list->pool->free = node;
+	}
+}
+
+
+/*
+ * Merges two sorted chains of nodes (ended with NULL) into one. The nodes of
+ *  the first chain go first when they are equal, so the merge is stable.
+ */
+static Node* mergeNodes (Node* first, Node* second, ElementCompare compare, void* context) {
+	Node merged;
+	Node* last = &merged;
+
+	while (NULL != first && NULL != second) {
+		if (compare(&(first->element), &(second->element), context) <= 0) {
+			last->next = first;
+			first = first->next;
+		}
+		else {
+			last->next = second;
+			second = second->next;
+		}
+		last = last->next;
+	}
+	last->next = (NULL != first) ? first : second;
+
+	return merged.next;
+}
+
+
+/*
+ * Links a node after the given node of the list, keeping the previous 
+ *  pointers, the tail and the size of the list up to date.
+ */
+static void linkAfter (LinkedList list, Node* previous, Node* node) {
+	node->prev = previous;
+	node->next = previous->next;
+	if (NULL != node->next) {
+		node->next->prev = node;
+	}
+	else {
+		list->tail = node;
+	}
+	previous->next = node;
+	list->size++;
+}
+
+
+/*
+ * Unlinks a node of the list, which is not freed. Its own pointers are not
+ *  changed.
+ */
+static void unlinkNode (LinkedList list, Node* node) {
+	node->prev->next = node->next;
+	if (NULL != node->next) {
+		node->next->prev = node->prev;
+	}
+	else {
+		list->tail = node->prev;
+	}
+	list->size--;
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Links the n given elements, in the same order, right after the
+ *				given node of the list. The nodes are carved in runs of
+ *				consecutive nodes if the list has a node pool. The size and
+ *				the tail of the list are kept up to date, but not the POV.
+ *			   If the list fails to create the nodes, the elements that could
+ *				be stored are linked and the error code is set to
+ *				LIST_ERROR_MALLOC.
+ *
+ * @Parameters: (in/out) list     = the linked list where to add the elements
+ *				(in)     previous = node after which the elements are linked
+ *				(in)     elements = array with the elements to add
+ *				(in)     n        = number of elements in the array
+ *				(out)    nodes    = array where to store the node of each 
+ *								    element, or NULL
+ * @Return: The node of the last element linked (previous if none)
+ *
+ ****************************************************************************/
+static Node* linkMany (LinkedList list, Node* previous, const Element* elements, int n, ListNode* nodes) {
+	Node* run = NULL;
+	int got = 0;
+	int i = 0, j = 0;
+
+	list->error = LIST_NO_ERROR;
+	METRICS_COUNT(METRIC_LIST_ADD, n);
+
+	while (i < n && LIST_NO_ERROR == list->error) {
+		// 1- Get the nodes for the next elements: a run of the pool or a
+		//    single node from malloc.
+		if (NULL != list->pool) {
+			run = allocRun(list->pool, n - i, &got);
+		}
+		else {
+			run = (Node*) malloc (sizeof(Node));
+			got = 1;
+			METRICS_COUNT(METRIC_LIST_NODES, 1);
+		}
+
+		if (NULL != run) {
+			// 2- Store the elements and chain the nodes of the run.
+			for (j = 0; j < got; j++) {
+				run[j].element = elements[i + j];
+				run[j].next = &(run[j + 1]);
+				run[j].prev = (0 == j) ? previous : &(run[j - 1]);
+				if (NULL != nodes) {
+					nodes[i + j] = &(run[j]);
+				}
+			}
+			// 3- Link the whole run after the previous node, as in the add,
+			//    and go on after its last node.
+			run[got - 1].next = previous->next;
+			previous->next = run;
+			previous = &(run[got - 1]);
+			if (NULL != previous->next) {
+				previous->next->prev = previous;
+			}
+			else {
+				list->tail = previous;
+			}
+			list->size += got;
+			i += got;
+		}
+		else {
+			list->error = LIST_ERROR_MALLOC;
+		}
+	}
+
+	return previous;
+}
+
+
 /**************************************************************************** 
  *
  * @Objective: Creates an empty linked list.
@@ -88,18 +379,95 @@ struct list_t {
  *
  ****************************************************************************/
 LinkedList LINKEDLIST_create () {
+	return LINKEDLIST_createWithPool (NULL);
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Creates an empty node pool. A node pool hands out list nodes
+ *				carved from big contiguous blocks of memory instead of 
+ *				requesting one dynamic memory block per element. The nodes
+ *				removed from a list go back to the pool to be reused.
+ *			   Returns NULL if the pool could not be created.
+ *
+ * @Parameters: ---
+ * @Return: An empty node pool
+ *
+ ****************************************************************************/
+NodePool LINKEDLIST_createPool () {
+	NodePool pool = (NodePool) malloc (sizeof(struct pool_t));
+
+	if (NULL != pool) {
+		// The blocks are requested on demand, when the first node is needed.
+		pool->blocks = NULL;
+		pool->used = 0;
+		pool->free = NULL;
+		pool->shared = NULL;
+	}
+
+	return pool;
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Creates an empty node pool for a single thread that will add
+ *				its nodes to the lists of a shared pool. It carves its own
+ *				blocks, so it can be used while another thread uses the
+ *				shared pool, and the lists of both pools can splice nodes
+ *				between them. In the end it must be merged into the shared
+ *				pool with LINKEDLIST_mergePool, never destroyed by itself.
+ *			   Returns NULL if the pool could not be created.
+ *
+ * @Parameters: (in/out) shared = the node pool that will own the nodes.
+ * @Return: An empty node pool
+ *
+ ****************************************************************************/
+NodePool LINKEDLIST_createLocalPool (NodePool shared) {
+	NodePool pool = LINKEDLIST_createPool();
+
+	if (NULL != pool) {
+		pool->shared = shared;
+	}
+
+	return pool;
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Creates an empty linked list whose nodes (phantom node 
+ *				included) are taken from the given node pool. Any number of
+ *				lists can share the same pool. A NULL pool means that the
+ *				nodes will be requested one by one with malloc.
+ *			   If the list fails to create the phantom node, it will set
+ *				the error code to LIST_ERROR_MALLOC.
+ *
+ * @Parameters: (in/out) pool = the node pool where to take the nodes from
+ * @Return: An empty linked list
+ *
+ ****************************************************************************/
+LinkedList LINKEDLIST_createWithPool (NodePool pool) {
 	LinkedList list = (LinkedList) malloc (sizeof(struct list_t));
 	
+	list->pool = pool;
+
 	// Request a Node. This node will be the auxiliary "Phantom" node.
 	// The list's head now is the phantom node.
-	list->head = (Node*) malloc(sizeof(Node));
+	list->head = allocNode(list);
 	if (NULL != list->head) {
-		// There is noone after the phantom node, so next is NULL.
+		// There is noone after or before the phantom node, so next and 
+		//  prev are NULL.
 		list->head->next = NULL;
+		list->head->prev = NULL;
 		// We set the previous pointer to the phantom node. Now the point
 		//  of view is after the last valid element in the list (there are 
 		//  no valid elements as the list is empty).
 		list->previous = list->head;
+		// The phantom node is also the last node.
+		list->tail = list->head;
+		list->size = 0;
 
 		// Everything was fine, so we set the error code to NO_ERROR
 		list->error = LIST_NO_ERROR;
@@ -144,18 +512,16 @@ LinkedList LINKEDLIST_create () {
  ****************************************************************************/
 void 	LINKEDLIST_add (LinkedList list, Element element) {
 	// 1- Create a new node to store the new element.
-	Node* new_node = (Node*) malloc (sizeof(Node));
+	Node* new_node = allocNode(list);
+	METRICS_COUNT(METRIC_LIST_ADD, 1);
 	if (NULL != new_node) {
 		// 2- Set the element field in the new node with the provided element.
 		new_node->element = element;
-		// 3- Set the next field in the new node.
-		//    The next node will be the node in the point of view.
-		new_node->next = list->previous->next;
-
-		// 4- Link the new node to the list. The new node will go before the
-		//    point of view, so 
-		list->previous->next = new_node;
-		// 5- Move the previous pointer.
+		// 3- Link the new node to the list. The new node will go before the
+		//    point of view, so after the previous node. Its next node will
+		//    be the node in the point of view.
+		linkAfter(list, list->previous, new_node);
+		// 4- Move the previous pointer.
 		list->previous = new_node;
 
 		// As everything was fine, set the error code to NO_ERROR
@@ -169,6 +535,92 @@ void 	LINKEDLIST_add (LinkedList list, Element element) {
 }
 
 
+/**************************************************************************** 
+ *
+ * @Objective: Inserts the n given elements in this list, in the same order,
+ *				before the element who is the current point of view. It is
+ *				the same as adding them one by one, but the nodes are linked
+ *				in a single pass and, if the list has a node pool, they are
+ *				carved in runs of consecutive nodes instead of one by one.
+ *			   If the nodes of the added elements are needed (e.g. to index
+ *				them), the nodes parameter can receive an array of n 
+ *				positions to store them. It can be NULL otherwise.
+ *			   If the list fails to create the nodes, the elements that could
+ *				be stored are added and the error code is set to 
+ *				LIST_ERROR_MALLOC.
+ *
+ *        +---+
+ *   prev | o-|-----------                                    Point of View
+ *        +---+           |                                  +---+---+
+ *                        v                           ------>| 2 | o-|--> ...
+ *                      +---+---+                    |       +---+---+
+ *                      | 1 | o-|--X                 |
+ *                      +---+---+  |   +---+---+     +---+---+
+ *                                  -->| A | o-|---->| B | o |  New nodes
+ *                                     +---+---+     +---+---+
+ *
+ * @Parameters: (in/out) list     = the linked list where to add the elements
+ *				(in)     elements = array with the elements to add
+ *				(in)     n        = number of elements in the array
+ *				(out)    nodes    = array where to store the node of each 
+ *								    element, or NULL
+ * @Return: ---
+ *
+ ****************************************************************************/
+void 	LINKEDLIST_addMany (LinkedList list, const Element* elements, int n, ListNode* nodes) {
+	// The POV stays on the same element, after the added ones.
+	list->previous = linkMany(list, list->previous, elements, n, nodes);
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Inserts the specified element at the end of this list, after
+ *				the last element, without walking the list. The POV does not
+ *				change: if it was after the last element, it is still after
+ *				the last element (the new one).
+ *			   If the list fails to create the new node to store the element,
+ *				it will set	the error code to LIST_ERROR_MALLOC.
+ *
+ * @Parameters: (in/out) list    = the linked list where to add the new element
+ *				(in)     element = the element to add to the list
+ * @Return: ---
+ *
+ ****************************************************************************/
+void 	LINKEDLIST_append (LinkedList list, Element element) {
+	LINKEDLIST_appendMany(list, &element, 1, NULL);
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Inserts the n given elements at the end of this list, in the
+ *				same order, as LINKEDLIST_addMany does before the POV. The
+ *				list is not walked: the elements are linked after the tail.
+ *				The POV does not change, as in LINKEDLIST_append.
+ *			   If the list fails to create the nodes, the elements that could
+ *				be stored are added and the error code is set to 
+ *				LIST_ERROR_MALLOC.
+ *
+ * @Parameters: (in/out) list     = the linked list where to add the elements
+ *				(in)     elements = array with the elements to add
+ *				(in)     n        = number of elements in the array
+ *				(out)    nodes    = array where to store the node of each 
+ *								    element, or NULL
+ * @Return: ---
+ *
+ ****************************************************************************/
+void 	LINKEDLIST_appendMany (LinkedList list, const Element* elements, int n, ListNode* nodes) {
+	int at_end = list->previous == list->tail;
+	Node* last = linkMany(list, list->tail, elements, n, nodes);
+
+	// A POV after the last element must stay after the new last element.
+	if (at_end) {
+		list->previous = last;
+	}
+}
+
+
 /**************************************************************************** 
  *
  * @Objective: Removes the element currently at the point of view in this 
@@ -210,10 +662,11 @@ void 	LINKEDLIST_remove (LinkedList list) {
 
 		// "Remove" the POV. The element after the PREVIOUS node will be the
 		//  element after the POV.
-		list->previous->next = list->previous->next->next;
+		unlinkNode(list, aux);
 
 		// Free the POV. Remove the element.
-		free(aux);
+		freeNode(list, aux);
+		METRICS_COUNT(METRIC_LIST_REMOVE, 1);
 
 		// If there are no errors, set error code to NO_ERROR.
 		list->error = LIST_NO_ERROR;
@@ -221,6 +674,147 @@ void 	LINKEDLIST_remove (LinkedList list) {
 }
 
 
+/**************************************************************************** 
+ *
+ * @Objective: Removes the element of the given node from the list without
+ *				walking it, as the node knows the node before it. The node 
+ *				must be in the list. If the POV was on the removed element,
+ *				it moves to the next element; any iterator on the removed 
+ *				element or right after it is no longer valid.
+ *			   This operation will fail if the node is NULL, setting the
+ *				error code to LIST_ERROR_END.
+ * 
+ * @Parameters: (in/out) list = the linked list where to remove the element.
+ *				(in)     node = the node of the element to remove.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	LINKEDLIST_removeNode (LinkedList list, ListNode node) {
+	if (NULL == node) {
+		list->error = LIST_ERROR_END;
+	}
+	else {
+		unlinkNode(list, node);
+		// The POV must not stay on a node that is given back.
+		if (list->previous == node) {
+			list->previous = node->prev;
+		}
+		freeNode(list, node);
+		METRICS_COUNT(METRIC_LIST_REMOVE, 1);
+
+		list->error = LIST_NO_ERROR;
+	}
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Moves the element currently at the point of view of the source
+ *				list to the destination list, before the element who is the
+ *				point of view of the destination list. The node itself is 
+ *				relinked: the element is not copied and no memory is 
+ *				requested, so any ListNode of the element is still valid.
+ *			   After the operation the POV of the source list is the element
+ *				that was after the moved one, and the POV of the destination
+ *				list does not change (as in LINKEDLIST_add).
+ *			   This operation will fail if the POV of the source list is 
+ *				after its last valid element, setting the error code of the
+ *				source list to LIST_ERROR_END, or if the lists do not take
+ *				their nodes from the same node pool, setting the error code
+ *				of the source list to LIST_ERROR_POOL.
+ *
+ *        +---+                               src POV
+ *   prev | o-|-------------      +---+---+     +---+---+     +---+----+ 
+ *        +---+             ----->| 1 | o-|--X->| 2 | o-|---->| 3 |NULL| 
+ *                                +---+---+ |   +---+---+     +---+----+
+ *                                          |         |         ^
+ *                                           ---------|---------
+ *                                                    |
+ *        +---+                                       | (relinked)  dst POV
+ *   prev | o-|-------------      +---+---+           v     +---+----+ 
+ *        +---+             ----->| A | o-|--X----> | 2 |-->| B |NULL| 
+ *                                +---+---+         +---+   +---+----+
+ *
+ * @Parameters: (in/out) src = the linked list where to take the element from
+ *				(in/out) dst = the linked list where to put the element
+ * @Return: ---
+ *
+ ****************************************************************************/
+void 	LINKEDLIST_spliceTo (LinkedList src, LinkedList dst) {
+	Node* aux = NULL;
+
+	if (LINKEDLIST_isAtEnd (src)) {
+		src->error = LIST_ERROR_END;
+	}
+	else if (ownerPool(src->pool) != ownerPool(dst->pool)) {
+		// The node would end up given back to an allocator that does not
+		//  own it.
+		src->error = LIST_ERROR_POOL;
+	}
+	else {
+		// 1- Unlink the POV node from the source list, as in the remove.
+		aux = src->previous->next;
+		unlinkNode(src, aux);
+
+		// 2- Link the same node before the POV of the destination list, as
+		//    in the add, and move the destination previous pointer.
+		linkAfter(dst, dst->previous, aux);
+		dst->previous = aux;
+
+		src->error = LIST_NO_ERROR;
+		dst->error = LIST_NO_ERROR;
+	}
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Moves all the elements of the source list to the end of the
+ *				destination list, in the same order, without walking any of
+ *				them: the nodes are relinked, so any ListNode of the elements
+ *				is still valid. The source list ends up empty. The POV of the
+ *				destination list does not change, as in LINKEDLIST_append.
+ *			   This operation will fail if the lists do not take their nodes
+ *				from the same node pool (a local pool and its shared pool
+ *				count as the same), setting the error code of the source
+ *				list to LIST_ERROR_POOL.
+ *
+ * @Parameters: (in/out) dst = the linked list where to put the elements.
+ *				(in/out) src = the linked list where to take them from.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void 	LINKEDLIST_appendList (LinkedList dst, LinkedList src) {
+	int at_end = dst->previous == dst->tail;
+
+	if (ownerPool(src->pool) != ownerPool(dst->pool)) {
+		src->error = LIST_ERROR_POOL;
+	}
+	else {
+		if (0 < src->size) {
+			// 1- Link the first node of the source after the tail of the
+			//    destination: the whole chain of nodes comes with it.
+			src->head->next->prev = dst->tail;
+			dst->tail->next = src->head->next;
+			dst->tail = src->tail;
+			dst->size += src->size;
+			// A POV after the last element must stay after the new last one.
+			if (at_end) {
+				dst->previous = dst->tail;
+			}
+
+			// 2- The source only keeps its phantom node.
+			src->head->next = NULL;
+			src->tail = src->head;
+			src->previous = src->head;
+			src->size = 0;
+		}
+		src->error = LIST_NO_ERROR;
+		dst->error = LIST_NO_ERROR;
+	}
+}
+
+
 /**************************************************************************** 
  *
  * @Objective: Returns the element currently at the point of view in this list.
@@ -243,6 +837,7 @@ Element LINKEDLIST_get (LinkedList list) {
 	else {
 		// The element to return is the element stored in the POV.
 		element = list->previous->next->element;
+		METRICS_COUNT(METRIC_LIST_GET, 1);
 
 		// If there are no errors, set error code to NO_ERROR.
 		list->error = LIST_NO_ERROR;
@@ -252,6 +847,368 @@ Element LINKEDLIST_get (LinkedList list) {
 }
 
 
+/**************************************************************************** 
+ *
+ * @Objective: Returns a pointer to the element currently at the point of
+ *				view in this list, without copying it. The pointer is valid
+ *				while the element stays in the list and must only be used to
+ *				read the element.
+ *			   This operation will fail if the POV is after the last valid
+ *				element of the list, returning NULL and setting the error 
+ *				code to LIST_ERROR_END.
+ * 
+ * @Parameters: (in/out) list = the linked list where to get the element.
+ *								in/out because we need to set the error code.
+ * @Return: A pointer to the element at the POV or NULL
+ *
+ ****************************************************************************/
+const Element* LINKEDLIST_peek (LinkedList list) {
+	const Element* element = NULL;
+
+	// We cannot return an element if the POV is not valid.
+	if (LINKEDLIST_isAtEnd (list)) {
+		list->error = LIST_ERROR_END;
+	}
+	else {
+		// The element is stored in the POV node, we only return its address.
+		element = &(list->previous->next->element);
+		METRICS_COUNT(METRIC_LIST_GET, 1);
+		list->error = LIST_NO_ERROR;
+	}
+
+	return element;
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Puts an iterator on the first element of the list. The list
+ *				is only read: neither its POV nor its error code change.
+ * 
+ * @Parameters: (in)     list     = the linked list to walk.
+ *				(out)    iterator = the iterator of the reader.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	LINKEDLIST_iterate (LinkedList list, ListIterator* iterator) {
+	// Like the POV, the iterator points to the node before its element.
+	iterator->list = list;
+	iterator->previous = list->head;
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Puts an iterator on the element right after the given node,
+ *				or on the first element if the node is NULL, without walking
+ *				the list. The node must be in the list.
+ * 
+ * @Parameters: (in)     list     = the linked list to walk.
+ *				(in)     node     = a node of the list or NULL.
+ *				(out)    iterator = the iterator.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	LINKEDLIST_iterateAfterNode (LinkedList list, ListNode node, ListIterator* iterator) {
+	iterator->list = list;
+	iterator->previous = (NULL != node) ? node : list->head;
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Puts an iterator on the element of the given node, without
+ *				walking the list. The node must be in the list (e.g. it 
+ *				comes from an index of the list that is kept up to date).
+ * 
+ * @Parameters: (in)     list     = the linked list to walk.
+ *				(in)     node     = a node of the list.
+ *				(out)    iterator = the iterator.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	LINKEDLIST_iterateAtNode (LinkedList list, ListNode node, ListIterator* iterator) {
+	iterator->list = list;
+	// The node before it is linked in the node itself.
+	iterator->previous = node->prev;
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Puts an iterator on the last element of the list, to walk it
+ *				backwards with LINKEDLIST_iteratorPrevious. If the list is
+ *				empty, the iterator is after the last element.
+ * 
+ * @Parameters: (in)     list     = the linked list to walk.
+ *				(out)    iterator = the iterator.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	LINKEDLIST_iterateLast (LinkedList list, ListIterator* iterator) {
+	iterator->list = list;
+	// The phantom node is the last node only when the list is empty.
+	iterator->previous = (list->tail != list->head) ? list->tail->prev : list->head;
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Moves the iterator to the previous element. From the first
+ *				element it goes after the last element, as the phantom node
+ *				is between them, so a backward walk ends as a forward one
+ *				(LINKEDLIST_iteratorPeek returns NULL). From after the last
+ *				element it goes to the last one.
+ * 
+ * @Parameters: (in/out) iterator = the iterator.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	LINKEDLIST_iteratorPrevious (ListIterator* iterator) {
+	if (iterator->previous == iterator->list->head) {
+		iterator->previous = iterator->list->tail;
+	}
+	else {
+		iterator->previous = iterator->previous->prev;
+		METRICS_COUNT(METRIC_LIST_NEXT, 1);
+	}
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Inserts an element before the element of the iterator, which
+ *				stays on the same element (as the POV in LINKEDLIST_add).
+ *			   If the list fails to create the new node, it will set the
+ *				error code of the list to LIST_ERROR_MALLOC.
+ * 
+ * @Parameters: (in/out) iterator = the iterator.
+ *				(in)     element  = the element to insert.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	LINKEDLIST_iteratorInsert (ListIterator* iterator, Element element) {
+	LinkedList list = iterator->list;
+	Node* new_node = allocNode(list);
+
+	METRICS_COUNT(METRIC_LIST_ADD, 1);
+	if (NULL != new_node) {
+		// Same as the add, with the iterator instead of the POV.
+		new_node->element = element;
+		linkAfter(list, iterator->previous, new_node);
+		iterator->previous = new_node;
+
+		list->error = LIST_NO_ERROR;
+	}
+	else {
+		list->error = LIST_ERROR_MALLOC;
+	}
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Removes the element of the iterator, which moves to the next
+ *				element. If the POV of the list was right after the removed
+ *				element, it moves back with the iterator; any other iterator
+ *				on the removed element or right after it is no longer valid.
+ *			   This operation will fail if the iterator is after the last
+ *				element, setting the error code of the list to
+ *				LIST_ERROR_END.
+ * 
+ * @Parameters: (in/out) iterator = the iterator.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	LINKEDLIST_iteratorRemove (ListIterator* iterator) {
+	LinkedList list = iterator->list;
+	Node* aux = NULL;
+
+	if (LINKEDLIST_iteratorIsAtEnd (iterator)) {
+		list->error = LIST_ERROR_END;
+	}
+	else {
+		// 1- Unlink the node of the iterator, as in the remove.
+		aux = iterator->previous->next;
+		unlinkNode(list, aux);
+
+		// 2- The POV must not stay on a node that is given back.
+		if (list->previous == aux) {
+			list->previous = iterator->previous;
+		}
+		freeNode(list, aux);
+		METRICS_COUNT(METRIC_LIST_REMOVE, 1);
+
+		list->error = LIST_NO_ERROR;
+	}
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Same as LINKEDLIST_spliceTo, with iterators: moves the element
+ *				of the source iterator before the element of the destination
+ *				iterator, relinking its node. The source iterator moves to the
+ *				next element and the destination iterator stays on the same
+ *				element. As in LINKEDLIST_iteratorRemove, the POV of the
+ *				source list is kept valid, but not the other iterators.
+ *			   This operation will fail if the source iterator is after the
+ *				last element (LIST_ERROR_END) or if the lists do not take
+ *				their nodes from the same node pool (LIST_ERROR_POOL),
+ *				setting the error code of the source list.
+ * 
+ * @Parameters: (in/out) src = the iterator of the element to move.
+ *				(in/out) dst = the iterator where to put the element.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	LINKEDLIST_iteratorSpliceTo (ListIterator* src, ListIterator* dst) {
+	Node* aux = NULL;
+
+	if (LINKEDLIST_iteratorIsAtEnd (src)) {
+		src->list->error = LIST_ERROR_END;
+	}
+	else if (ownerPool(src->list->pool) != ownerPool(dst->list->pool)) {
+		src->list->error = LIST_ERROR_POOL;
+	}
+	else {
+		// 1- Unlink the node from the source list.
+		aux = src->previous->next;
+		unlinkNode(src->list, aux);
+		if (src->list->previous == aux) {
+			src->list->previous = src->previous;
+		}
+
+		// 2- Link it before the element of the destination iterator.
+		linkAfter(dst->list, dst->previous, aux);
+		dst->previous = aux;
+
+		src->list->error = LIST_NO_ERROR;
+		dst->list->error = LIST_NO_ERROR;
+	}
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Returns the node currently at the point of view in this list.
+ *				The node identifies the element while it stays in the list,
+ *				so it can be kept to go back to the element later on.
+ *			   This operation will fail if the POV is after the last valid
+ *				element of the list, returning NULL and setting the error 
+ *				code to LIST_ERROR_END.
+ * 
+ * @Parameters: (in/out) list = the linked list where to get the node.
+ *								in/out because we need to set the error code.
+ * @Return: The node at the POV or NULL
+ *
+ ****************************************************************************/
+ListNode LINKEDLIST_getNode (LinkedList list) {
+	ListNode node = NULL;
+
+	if (LINKEDLIST_isAtEnd (list)) {
+		list->error = LIST_ERROR_END;
+	}
+	else {
+		// The node at the POV is the one after PREVIOUS.
+		node = list->previous->next;
+		list->error = LIST_NO_ERROR;
+	}
+
+	return node;
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Moves the point of view to the element right after the given
+ *				node, or to the first element if the node is NULL, without
+ *				walking the list. The node must be in the list (e.g. it
+ *				comes from an index of the list that is kept up to date).
+ * 
+ * @Parameters: (in/out) list = the linked list to move the POV.
+ *				(in)     node = a node of the list or NULL.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void 	LINKEDLIST_goAfterNode (LinkedList list, ListNode node) {
+	// The node before the POV is the given one (or the phantom node).
+	list->previous = (NULL != node) ? node : list->head;
+	list->error = LIST_NO_ERROR;
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Sorts the list with a stable merge sort. The nodes are relinked,
+ *				no element is copied and no memory is requested, so any 
+ *				ListNode of the elements is still valid. A list that is 
+ *				already sorted is only walked once.
+ *			   After the operation the POV is the first element.
+ *
+ *			   The merge sort works bottom-up: bins[i] holds a sorted chain
+ *				of 2^i nodes, and every new node is merged with the full bins
+ *				as in a binary counter, so there is no recursion.
+ * 
+ * @Parameters: (in/out) list    = the linked list to sort.
+ *				(in)     compare = the order to sort the list
+ *				(in)     context = passed as is to the compare function
+ * @Return: ---
+ *
+ ****************************************************************************/
+void 	LINKEDLIST_sort (LinkedList list, ElementCompare compare, void* context) {
+	Node* bins[64];
+	Node* node = list->head->next;
+	Node* carry = NULL;
+	int used = 0, i = 0;
+
+	// 1- Check if the list is already sorted.
+	while (NULL != node && NULL != node->next && compare(&(node->element), &(node->next->element), context) <= 0) {
+		node = node->next;
+	}
+
+	if (NULL != node && NULL != node->next) {
+		// 2- Take the nodes one by one. The bins hold older nodes than the
+		//    carry, so they go first in the merge.
+		node = list->head->next;
+		while (NULL != node) {
+			carry = node;
+			node = node->next;
+			carry->next = NULL;
+			for (i = 0; i < used && NULL != bins[i]; i++) {
+				carry = mergeNodes(bins[i], carry, compare, context);
+				bins[i] = NULL;
+			}
+			if (i == used) {
+				used++;
+			}
+			bins[i] = carry;
+		}
+
+		// 3- Merge the bins, the bigger ones hold the older nodes.
+		carry = NULL;
+		for (i = 0; i < used; i++) {
+			if (NULL != bins[i]) {
+				carry = mergeNodes(bins[i], carry, compare, context);
+			}
+		}
+		list->head->next = carry;
+
+		// 4- The merge only links the next pointers: link the previous
+		//    ones again and find the last node.
+		node = list->head;
+		while (NULL != node->next) {
+			node->next->prev = node;
+			node = node->next;
+		}
+		list->tail = node;
+	}
+
+	list->previous = list->head;
+	list->error = LIST_NO_ERROR;
+}
+
+
 /**************************************************************************** 
  *
  * @Objective: Returns true (!0) if this list contains no elements.
@@ -266,6 +1223,20 @@ int 	LINKEDLIST_isEmpty (LinkedList list) {
 }
 
 
+/**************************************************************************** 
+ *
+ * @Objective: Returns the number of elements in this list, without walking
+ *				it.
+ * 
+ * @Parameters: (in)     list = the linked list to check
+ * @Return: The number of elements in the list
+ *
+ ****************************************************************************/
+int 	LINKEDLIST_size (LinkedList list) {
+	return list->size;
+}
+
+
 /**************************************************************************** 
  *
  * @Objective: Moves the point of view to the first element in the list.
@@ -302,6 +1273,7 @@ void 	LINKEDLIST_next (LinkedList list) {
 	else {
 		// Move the POV to the next element.
 		list->previous = list->previous->next;
+		METRICS_COUNT(METRIC_LIST_NEXT, 1);
 
 		// If there are no errors, set error code to NO_ERROR.
 		list->error = LIST_NO_ERROR;
@@ -343,17 +1315,128 @@ void 	LINKEDLIST_destroy (LinkedList* list) {
 		aux = (*list)->head;
 		// Now the first node is the next node.
 		(*list)->head = (*list)->head->next;
-		// Free who was the first node;
-		free(aux);
+		// Free who was the first node (or give it back to the pool);
+		freeNode(*list, aux);
 	}
 	// Set the pointers to NULL (best practice).
 	(*list)->head = NULL;
 	(*list)->previous = NULL;
+	(*list)->tail = NULL;
+	(*list)->size = 0;
+
+	(*list)->pool = NULL;
 
 	free(*list);
 	*list = NULL;
 }
 
+
+/**************************************************************************** 
+ *
+ * @Objective: Frees the list without walking it, when its nodes (the 
+ *				phantom node included) are freed together with its node pool
+ *				by LINKEDLIST_destroyPool: they are not given back to the 
+ *				pool one by one, so they cannot be reused. A list without
+ *				node pool is destroyed as in LINKEDLIST_destroy. The list 
+ *				must be created again before usage.
+ * 
+ * @Parameters: (in/out) list = the linked list to release.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void 	LINKEDLIST_release (LinkedList* list) {
+	if (NULL == (*list)->pool) {
+		LINKEDLIST_destroy(list);
+	}
+	else {
+		// The nodes stay in the blocks of the pool, which frees them all.
+		free(*list);
+		*list = NULL;
+	}
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Frees all the memory blocks of the node pool in one go. Every
+ *				node handed out by the pool is released, so all the lists 
+ *				created with this pool must be destroyed before (or must not
+ *				be used anymore).
+ * 
+ * @Parameters: (in/out) pool = the node pool to destroy.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void 	LINKEDLIST_destroyPool (NodePool* pool) {
+	Block* aux;
+	// While there are still blocks in the pool.
+	while (NULL != (*pool)->blocks) {
+		aux = (*pool)->blocks;
+		(*pool)->blocks = (*pool)->blocks->next;
+		free(aux);
+	}
+	// The free list pointed inside the blocks, so it is gone too.
+	(*pool)->free = NULL;
+
+	free(*pool);
+	*pool = NULL;
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Gives all the blocks and free nodes of a pool created with
+ *				LINKEDLIST_createLocalPool to its shared pool, and frees the
+ *				local pool. The nodes in use stay where they are, in the
+ *				lists of either pool. The lists created with the local pool
+ *				must be destroyed or released before. No other thread may
+ *				use the shared pool meanwhile.
+ *
+ * @Parameters: (in/out) local = the local node pool to merge.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void 	LINKEDLIST_mergePool (NodePool* local) {
+	NodePool shared = (*local)->shared;
+	Block* last = (*local)->blocks;
+	Node* node = NULL;
+
+	// 1- The shared pool only carves nodes from its own newest block, so the
+	//    nodes never carved from the newest local block go to the free list.
+	while (NULL != (*local)->blocks && POOL_BLOCK_NODES != (*local)->used) {
+		(*local)->blocks->nodes[(*local)->used].next = (*local)->free;
+		(*local)->free = &((*local)->blocks->nodes[(*local)->used]);
+		(*local)->used++;
+	}
+
+	// 2- The local blocks go after the newest shared block, which is still
+	//    the one the shared pool carves from.
+	if (NULL != last) {
+		while (NULL != last->next) {
+			last = last->next;
+		}
+		if (NULL == shared->blocks) {
+			shared->blocks = (*local)->blocks;
+			shared->used = POOL_BLOCK_NODES;
+		}
+		else {
+			last->next = shared->blocks->next;
+			shared->blocks->next = (*local)->blocks;
+		}
+	}
+
+	// 3- The free nodes of the local pool can be reused by the shared one.
+	while (NULL != (*local)->free) {
+		node = (*local)->free;
+		(*local)->free = node->next;
+		node->next = shared->free;
+		shared->free = node;
+	}
+
+	free(*local);
+	*local = NULL;
+}
+
 /*
  * Another implementation of the destroy.
  *
@@ -377,7 +1460,11 @@ void LINKEDLIST_destroy (LinkedList* list) {
  *
  * @Objective: This function returns the error code provided by the last 
  *				operation run. The operations that update the error code are:
- *				Create, Add, Remove and Get.
+ *				Create, Add, AddMany, Append, AppendMany, AppendList, Remove,
+ *				RemoveNode, SpliceTo, Get, Peek, Next, GetNode, GoAfterNode,
+ *				Sort and the iterator operations that change a list
+ *				(IteratorInsert, IteratorRemove and IteratorSpliceTo). The
+ *				node pool and the walks of the iterators do not use it.
  * @Parameters: (in)     list = the linked list to check.
  * @Return: an error code from the list of constants defined.
  *
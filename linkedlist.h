@@ -27,11 +27,17 @@
 #define LIST_ERROR_EMPTY 2			// Error, the list is empty.
 #define LIST_ERROR_MALLOC 3			// Error, a malloc failed.
 #define LIST_ERROR_END 4			// Error, the POV is at the end.
+#define LIST_ERROR_POOL 5			// Error, the lists use different node pools.
 #define MAX_STRING_LENGTH 70
 
+// The texts of the students are stored in a string table, a student only
+//  keeps their handles (the list does not use the table).
+#include "stringid.h"
+#include "metrics.h"			// Counters of the iterators (only with ENABLE_METRICS).
+
 typedef struct {
-	char name[MAX_STRING_LENGTH]; 
-	char login[MAX_STRING_LENGTH];
+	StringId name; 
+	StringId login;
 } Student;
 
 // Data types
@@ -39,6 +45,41 @@ typedef Student Element;
 
 typedef struct list_t* LinkedList;
 
+typedef struct pool_t* NodePool;
+
+typedef struct _Node* ListNode;
+
+/*
+ * Node is a recursive structure that will contain each one of the elements.
+ * A node has three fields, the element to store and pointers to the next 
+ *  and to the previous node in the Linear Data Structure. The pointer to the
+ *  previous node lets a node be unlinked without walking the list to find
+ *  who is before it, and the list be walked backwards.
+ * Its layout is public only so that the iterator functions that read the
+ *  list (peek, next, get...) are inlined in the loops of its users, which
+ *  call them once per element. The list and the node pool stay opaque, and
+ *  the nodes must only be changed through the functions of the list.
+ */
+struct _Node {
+	Element element;
+	struct _Node * next;
+	struct _Node * prev;	// NULL in the phantom node;
+};
+
+// Position in a list, declared by its user (e.g. on the stack). It does not
+//  use the POV of the list, so several readers can walk the same list at the
+//  same time, and an algorithm can keep several positions in the same list.
+//  It can walk the list in both directions.
+typedef struct {
+	LinkedList list;			// List that is being walked;
+	ListNode previous;			// Node before the element of the iterator;
+} ListIterator;
+
+// Function to compare two elements: returns a negative number, zero or a
+//  positive number if a goes before, together with or after b. The context
+//  is passed as is (e.g. the string table where the texts are).
+typedef int (*ElementCompare) (const Element* a, const Element* b, void* context);
+
 
 // Procedures & Functions
 
@@ -55,6 +96,54 @@ typedef struct list_t* LinkedList;
 LinkedList LINKEDLIST_create ();
 
 
+/**************************************************************************** 
+ *
+ * @Objective: Creates an empty node pool. A node pool hands out list nodes
+ *				carved from big contiguous blocks of memory instead of 
+ *				requesting one dynamic memory block per element. The nodes
+ *				removed from a list go back to the pool to be reused.
+ *			   Returns NULL if the pool could not be created.
+ *
+ * @Parameters: ---
+ * @Return: An empty node pool
+ *
+ ****************************************************************************/
+NodePool LINKEDLIST_createPool ();
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Creates an empty node pool for a single thread that will add
+ *				its nodes to the lists of a shared pool. It carves its own
+ *				blocks, so it can be used while another thread uses the
+ *				shared pool, and the lists of both pools can splice nodes
+ *				between them. In the end it must be merged into the shared
+ *				pool with LINKEDLIST_mergePool, never destroyed by itself.
+ *			   Returns NULL if the pool could not be created.
+ *
+ * @Parameters: (in/out) shared = the node pool that will own the nodes.
+ * @Return: An empty node pool
+ *
+ ****************************************************************************/
+NodePool LINKEDLIST_createLocalPool (NodePool shared);
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Creates an empty linked list whose nodes (phantom node 
+ *				included) are taken from the given node pool. Any number of
+ *				lists can share the same pool. A NULL pool means that the
+ *				nodes will be requested one by one with malloc.
+ *			   If the list fails to create the phantom node, it will set
+ *				the error code to LIST_ERROR_MALLOC.
+ *
+ * @Parameters: (in/out) pool = the node pool where to take the nodes from
+ * @Return: An empty linked list
+ *
+ ****************************************************************************/
+LinkedList LINKEDLIST_createWithPool (NodePool pool);
+
+
 /**************************************************************************** 
  *
  * @Objective: Inserts the specified element in this list before the element
@@ -71,6 +160,69 @@ LinkedList LINKEDLIST_create ();
 void 	LINKEDLIST_add (LinkedList list, Element element);
 
 
+/**************************************************************************** 
+ *
+ * @Objective: Inserts the n given elements in this list, in the same order,
+ *				before the element who is the current point of view. It is
+ *				the same as adding them one by one, but the nodes are linked
+ *				in a single pass and, if the list has a node pool, they are
+ *				carved in runs of consecutive nodes instead of one by one.
+ *			   If the nodes of the added elements are needed (e.g. to index
+ *				them), the nodes parameter can receive an array of n 
+ *				positions to store them. It can be NULL otherwise.
+ *			   If the list fails to create the nodes, the elements that could
+ *				be stored are added and the error code is set to 
+ *				LIST_ERROR_MALLOC.
+ *
+ * @Parameters: (in/out) list     = the linked list where to add the elements
+ *				(in)     elements = array with the elements to add
+ *				(in)     n        = number of elements in the array
+ *				(out)    nodes    = array where to store the node of each 
+ *								    element, or NULL
+ * @Return: ---
+ *
+ ****************************************************************************/
+void 	LINKEDLIST_addMany (LinkedList list, const Element* elements, int n, ListNode* nodes);
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Inserts the specified element at the end of this list, after
+ *				the last element, without walking the list. The POV does not
+ *				change: if it was after the last element, it is still after
+ *				the last element (the new one).
+ *			   If the list fails to create the new node to store the element,
+ *				it will set	the error code to LIST_ERROR_MALLOC.
+ *
+ * @Parameters: (in/out) list    = the linked list where to add the new element
+ *				(in)     element = the element to add to the list
+ * @Return: ---
+ *
+ ****************************************************************************/
+void 	LINKEDLIST_append (LinkedList list, Element element);
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Inserts the n given elements at the end of this list, in the
+ *				same order, as LINKEDLIST_addMany does before the POV. The
+ *				list is not walked: the elements are linked after the tail.
+ *				The POV does not change, as in LINKEDLIST_append.
+ *			   If the list fails to create the nodes, the elements that could
+ *				be stored are added and the error code is set to 
+ *				LIST_ERROR_MALLOC.
+ *
+ * @Parameters: (in/out) list     = the linked list where to add the elements
+ *				(in)     elements = array with the elements to add
+ *				(in)     n        = number of elements in the array
+ *				(out)    nodes    = array where to store the node of each 
+ *								    element, or NULL
+ * @Return: ---
+ *
+ ****************************************************************************/
+void 	LINKEDLIST_appendMany (LinkedList list, const Element* elements, int n, ListNode* nodes);
+
+
 /**************************************************************************** 
  *
  * @Objective: Removes the element currently at the point of view in this 
@@ -87,6 +239,68 @@ void 	LINKEDLIST_add (LinkedList list, Element element);
 void 	LINKEDLIST_remove (LinkedList list);
 
 
+/**************************************************************************** 
+ *
+ * @Objective: Removes the element of the given node from the list without
+ *				walking it, as the node knows the node before it. The node 
+ *				must be in the list. If the POV was on the removed element,
+ *				it moves to the next element; any iterator on the removed 
+ *				element or right after it is no longer valid.
+ *			   This operation will fail if the node is NULL, setting the
+ *				error code to LIST_ERROR_END.
+ * 
+ * @Parameters: (in/out) list = the linked list where to remove the element.
+ *				(in)     node = the node of the element to remove.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	LINKEDLIST_removeNode (LinkedList list, ListNode node);
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Moves the element currently at the point of view of the source
+ *				list to the destination list, before the element who is the
+ *				point of view of the destination list. The node itself is 
+ *				relinked: the element is not copied and no memory is 
+ *				requested, so any ListNode of the element is still valid.
+ *			   After the operation the POV of the source list is the element
+ *				that was after the moved one, and the POV of the destination
+ *				list does not change (as in LINKEDLIST_add).
+ *			   This operation will fail if the POV of the source list is 
+ *				after its last valid element, setting the error code of the
+ *				source list to LIST_ERROR_END, or if the lists do not take
+ *				their nodes from the same node pool, setting the error code
+ *				of the source list to LIST_ERROR_POOL.
+ *
+ * @Parameters: (in/out) src = the linked list where to take the element from
+ *				(in/out) dst = the linked list where to put the element
+ * @Return: ---
+ *
+ ****************************************************************************/
+void 	LINKEDLIST_spliceTo (LinkedList src, LinkedList dst);
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Moves all the elements of the source list to the end of the
+ *				destination list, in the same order, without walking any of
+ *				them: the nodes are relinked, so any ListNode of the elements
+ *				is still valid. The source list ends up empty. The POV of the
+ *				destination list does not change, as in LINKEDLIST_append.
+ *			   This operation will fail if the lists do not take their nodes
+ *				from the same node pool (a local pool and its shared pool
+ *				count as the same), setting the error code of the source
+ *				list to LIST_ERROR_POOL.
+ *
+ * @Parameters: (in/out) dst = the linked list where to put the elements.
+ *				(in/out) src = the linked list where to take them from.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void 	LINKEDLIST_appendList (LinkedList dst, LinkedList src);
+
+
 /**************************************************************************** 
  *
  * @Objective: Returns the element currently at the point of view in this list.
@@ -103,6 +317,308 @@ void 	LINKEDLIST_remove (LinkedList list);
 Element LINKEDLIST_get (LinkedList list);
 
 
+/**************************************************************************** 
+ *
+ * @Objective: Returns a pointer to the element currently at the point of
+ *				view in this list, without copying it. The pointer is valid
+ *				while the element stays in the list and must only be used to
+ *				read the element.
+ *			   This operation will fail if the POV is after the last valid
+ *				element of the list, returning NULL and setting the error 
+ *				code to LIST_ERROR_END.
+ * 
+ * @Parameters: (in/out) list = the linked list where to get the element.
+ *								in/out because we need to set the error code.
+ * @Return: A pointer to the element at the POV or NULL
+ *
+ ****************************************************************************/
+const Element* LINKEDLIST_peek (LinkedList list);
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Puts an iterator on the first element of the list. The list
+ *				is only read: neither its POV nor its error code change.
+ * 
+ * @Parameters: (in)     list     = the linked list to walk.
+ *				(out)    iterator = the iterator of the reader.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	LINKEDLIST_iterate (LinkedList list, ListIterator* iterator);
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Returns a pointer to the element of the iterator, without
+ *				copying it, or NULL if the iterator is after the last element.
+ * 
+ * @Parameters: (in)     iterator = the iterator of the reader.
+ * @Return: A pointer to the element of the iterator or NULL
+ *
+ ****************************************************************************/
+static inline const Element* LINKEDLIST_iteratorPeek (const ListIterator* iterator) {
+	const Element* element = NULL;
+
+	if (NULL != iterator->previous->next) {
+		element = &(iterator->previous->next->element);
+		METRICS_COUNT(METRIC_LIST_GET, 1);
+	}
+
+	return element;
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Moves the iterator to the next element. It does nothing if
+ *				the iterator is already after the last element.
+ * 
+ * @Parameters: (in/out) iterator = the iterator of the reader.
+ * @Return: ---
+ *
+ ****************************************************************************/
+static inline void	LINKEDLIST_iteratorNext (ListIterator* iterator) {
+	if (NULL != iterator->previous->next) {
+		iterator->previous = iterator->previous->next;
+		METRICS_COUNT(METRIC_LIST_NEXT, 1);
+	}
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Puts an iterator on the element right after the given node,
+ *				or on the first element if the node is NULL, without walking
+ *				the list. The node must be in the list.
+ * 
+ * @Parameters: (in)     list     = the linked list to walk.
+ *				(in)     node     = a node of the list or NULL.
+ *				(out)    iterator = the iterator.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	LINKEDLIST_iterateAfterNode (LinkedList list, ListNode node, ListIterator* iterator);
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Puts an iterator on the element of the given node, without
+ *				walking the list. The node must be in the list (e.g. it 
+ *				comes from an index of the list that is kept up to date).
+ * 
+ * @Parameters: (in)     list     = the linked list to walk.
+ *				(in)     node     = a node of the list.
+ *				(out)    iterator = the iterator.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	LINKEDLIST_iterateAtNode (LinkedList list, ListNode node, ListIterator* iterator);
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Puts an iterator on the last element of the list, to walk it
+ *				backwards with LINKEDLIST_iteratorPrevious. If the list is
+ *				empty, the iterator is after the last element.
+ * 
+ * @Parameters: (in)     list     = the linked list to walk.
+ *				(out)    iterator = the iterator.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	LINKEDLIST_iterateLast (LinkedList list, ListIterator* iterator);
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Moves the iterator to the previous element. From the first
+ *				element it goes after the last element, as the phantom node
+ *				is between them, so a backward walk ends as a forward one
+ *				(LINKEDLIST_iteratorPeek returns NULL). From after the last
+ *				element it goes to the last one.
+ * 
+ * @Parameters: (in/out) iterator = the iterator.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	LINKEDLIST_iteratorPrevious (ListIterator* iterator);
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Returns true (!0) if the iterator is after the last element.
+ * 
+ * @Parameters: (in)     iterator = the iterator.
+ * @Return: true (!0) if the iterator is after the last element
+ *
+ ****************************************************************************/
+static inline int		LINKEDLIST_iteratorIsAtEnd (const ListIterator* iterator) {
+	return NULL == iterator->previous->next;
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Returns a copy of the element of the iterator. The iterator
+ *				must not be after the last element.
+ * 
+ * @Parameters: (in)     iterator = the iterator.
+ * @Return: The element of the iterator
+ *
+ ****************************************************************************/
+static inline Element	LINKEDLIST_iteratorGet (const ListIterator* iterator) {
+	METRICS_COUNT(METRIC_LIST_GET, 1);
+	return iterator->previous->next->element;
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Returns the node of the element of the iterator, or NULL if
+ *				the iterator is after the last element.
+ * 
+ * @Parameters: (in)     iterator = the iterator.
+ * @Return: The node of the element of the iterator or NULL
+ *
+ ****************************************************************************/
+static inline ListNode LINKEDLIST_iteratorNode (const ListIterator* iterator) {
+	return iterator->previous->next;
+}
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Inserts an element before the element of the iterator, which
+ *				stays on the same element (as the POV in LINKEDLIST_add).
+ *			   If the list fails to create the new node, it will set the
+ *				error code of the list to LIST_ERROR_MALLOC.
+ * 
+ * @Parameters: (in/out) iterator = the iterator.
+ *				(in)     element  = the element to insert.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	LINKEDLIST_iteratorInsert (ListIterator* iterator, Element element);
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Removes the element of the iterator, which moves to the next
+ *				element. If the POV of the list was right after the removed
+ *				element, it moves back with the iterator; any other iterator
+ *				on the removed element or right after it is no longer valid.
+ *			   This operation will fail if the iterator is after the last
+ *				element, setting the error code of the list to
+ *				LIST_ERROR_END.
+ * 
+ * @Parameters: (in/out) iterator = the iterator.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	LINKEDLIST_iteratorRemove (ListIterator* iterator);
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Same as LINKEDLIST_spliceTo, with iterators: moves the element
+ *				of the source iterator before the element of the destination
+ *				iterator, relinking its node. The source iterator moves to the
+ *				next element and the destination iterator stays on the same
+ *				element. As in LINKEDLIST_iteratorRemove, the POV of the
+ *				source list is kept valid, but not the other iterators.
+ *			   This operation will fail if the source iterator is after the
+ *				last element (LIST_ERROR_END) or if the lists do not take
+ *				their nodes from the same node pool (LIST_ERROR_POOL),
+ *				setting the error code of the source list.
+ * 
+ * @Parameters: (in/out) src = the iterator of the element to move.
+ *				(in/out) dst = the iterator where to put the element.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	LINKEDLIST_iteratorSpliceTo (ListIterator* src, ListIterator* dst);
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Walks the whole list from its first element with an iterator
+ *				of the reader, leaving in the pointer "element" (const 
+ *				Element*) each one of the elements without copying them. The
+ *				POV of the list is not used, so the list is only read.
+ *
+ *				ListIterator iterator;
+ *				const Element* element;
+ *				LINKEDLIST_FOREACH_READ(list, iterator, element) {
+ *					... element->login ...
+ *				}
+ *
+ ****************************************************************************/
+#define LINKEDLIST_FOREACH_READ(list, iterator, element) \
+	for (LINKEDLIST_iterate((list), &(iterator)); NULL != ((element) = LINKEDLIST_iteratorPeek(&(iterator))); \
+		LINKEDLIST_iteratorNext(&(iterator)))
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Same as LINKEDLIST_FOREACH_READ, from the last element to the
+ *				first one.
+ *
+ ****************************************************************************/
+#define LINKEDLIST_FOREACH_REVERSE_READ(list, iterator, element) \
+	for (LINKEDLIST_iterateLast((list), &(iterator)); NULL != ((element) = LINKEDLIST_iteratorPeek(&(iterator))); \
+		LINKEDLIST_iteratorPrevious(&(iterator)))
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Returns the node currently at the point of view in this list.
+ *				The node identifies the element while it stays in the list,
+ *				so it can be kept to go back to the element later on.
+ *			   This operation will fail if the POV is after the last valid
+ *				element of the list, returning NULL and setting the error 
+ *				code to LIST_ERROR_END.
+ * 
+ * @Parameters: (in/out) list = the linked list where to get the node.
+ *								in/out because we need to set the error code.
+ * @Return: The node at the POV or NULL
+ *
+ ****************************************************************************/
+ListNode LINKEDLIST_getNode (LinkedList list);
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Moves the point of view to the element right after the given
+ *				node, or to the first element if the node is NULL, without
+ *				walking the list. The node must be in the list (e.g. it
+ *				comes from an index of the list that is kept up to date).
+ * 
+ * @Parameters: (in/out) list = the linked list to move the POV.
+ *				(in)     node = a node of the list or NULL.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void 	LINKEDLIST_goAfterNode (LinkedList list, ListNode node);
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Sorts the list with a stable merge sort. The nodes are relinked,
+ *				no element is copied and no memory is requested, so any 
+ *				ListNode of the elements is still valid. A list that is 
+ *				already sorted is only walked once.
+ *			   After the operation the POV is the first element.
+ * 
+ * @Parameters: (in/out) list    = the linked list to sort.
+ *				(in)     compare = the order to sort the list
+ *				(in)     context = passed as is to the compare function
+ * @Return: ---
+ *
+ ****************************************************************************/
+void 	LINKEDLIST_sort (LinkedList list, ElementCompare compare, void* context);
+
+
 /**************************************************************************** 
  *
  * @Objective: Returns true (!0) if this list contains no elements.
@@ -114,6 +630,18 @@ Element LINKEDLIST_get (LinkedList list);
 int 	LINKEDLIST_isEmpty (LinkedList list);
 
 
+/**************************************************************************** 
+ *
+ * @Objective: Returns the number of elements in this list, without walking
+ *				it.
+ * 
+ * @Parameters: (in)     list = the linked list to check
+ * @Return: The number of elements in the list
+ *
+ ****************************************************************************/
+int 	LINKEDLIST_size (LinkedList list);
+
+
 /**************************************************************************** 
  *
  * @Objective: Moves the point of view to the first element in the list.
@@ -164,11 +692,61 @@ int 	LINKEDLIST_isAtEnd (LinkedList list);
 void 	LINKEDLIST_destroy (LinkedList* list);
 
 
+/**************************************************************************** 
+ *
+ * @Objective: Frees the list without walking it, when its nodes (the 
+ *				phantom node included) are freed together with its node pool
+ *				by LINKEDLIST_destroyPool: they are not given back to the 
+ *				pool one by one, so they cannot be reused. A list without
+ *				node pool is destroyed as in LINKEDLIST_destroy. The list 
+ *				must be created again before usage.
+ * 
+ * @Parameters: (in/out) list = the linked list to release.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void 	LINKEDLIST_release (LinkedList* list);
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Frees all the memory blocks of the node pool in one go. Every
+ *				node handed out by the pool is released, so all the lists 
+ *				created with this pool must be destroyed before (or must not
+ *				be used anymore).
+ * 
+ * @Parameters: (in/out) pool = the node pool to destroy.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void 	LINKEDLIST_destroyPool (NodePool* pool);
+
+
+/**************************************************************************** 
+ *
+ * @Objective: Gives all the blocks and free nodes of a pool created with
+ *				LINKEDLIST_createLocalPool to its shared pool, and frees the
+ *				local pool. The nodes in use stay where they are, in the
+ *				lists of either pool. The lists created with the local pool
+ *				must be destroyed or released before. No other thread may
+ *				use the shared pool meanwhile.
+ *
+ * @Parameters: (in/out) local = the local node pool to merge.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void 	LINKEDLIST_mergePool (NodePool* local);
+
+
 /**************************************************************************** 
  *
  * @Objective: This function returns the error code provided by the last 
  *				operation run. The operations that update the error code are:
- *				Create, Add, Remove and Get.
+ *				Create, Add, AddMany, Append, AppendMany, AppendList, Remove,
+ *				RemoveNode, SpliceTo, Get, Peek, Next, GetNode, GoAfterNode,
+ *				Sort and the iterator operations that change a list
+ *				(IteratorInsert, IteratorRemove and IteratorSpliceTo). The
+ *				node pool and the walks of the iterators do not use it.
  * 
  * @Parameters: (in)     list = the linked list to check.
  * @Return: an error code from the list of constants defined.
@@ -11,40 +11,222 @@
 // Llibreries del sistema
 #include <stdlib.h>				
 #include "linkedlist.h"
+#include "stringtable.h"
+#include "mappedfile.h"
+#include "skiplist.h"
+#include "metrics.h"
 #include <stdio.h>
+#include <stdarg.h>
 #include <string.h>
-
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+
+// Constants
+#define LOAD_BATCH 4096					// Estudiants que es llegeixen abans d'afegir-los a les llistes.
+#define MAX_THREADS 64					// Nombre màxim de fils per llegir el fitxer d'estudiants.
+#define UNLIMITED -1					// Capacitat màxima d'una classe sense límit.
+#define SCRIPT_LINE_LENGTH 256			// Longitud màxima d'una línia del fitxer de comandes.
+#define OUTPUT_BUFFER (1 << 20)			// Mida del buffer de sortida en el mode no interactiu.
+#define SNAPSHOT_MAGIC "CLASSNAP"		// Primers 8 bytes d'un fitxer snapshot.
+#define SNAPSHOT_VERSION 1				// Versió del format dels fitxers snapshot.
+#define JOURNAL_SYNC_BATCH 256			// Moviments del journal que s'escriuen al disc de cop (fsync).
+#define JOURNAL_COMPACT_RECORDS 100000	// Moviments del journal a partir dels quals es compacta.
+#define CSV_HEADER "degree,classroom,login,name"	// Primera línia d'una exportació CSV.
+#define CSV_FIELD_LENGTH 1024			// Longitud màxima d'un camp CSV amb cometes dobles.
 
 //Tipus propis
 
+typedef struct {
+	char *text;							// Sortida ja preparada, es mostra amb un sol fwrite.
+	long length;
+	long max_length;
+	int valid;							// Variable flag que val 1 si el text correspon a l'estat actual (atòmica).
+} OutputCache;
 
 typedef struct {
-char name[MAX_STRING_LENGTH]; 
-int current_capacity;
-LinkedList students;
+StringId name; 
+int staged;								// Estudiants que la classe guanya (o perd) amb canvis que encara no són a la llista.
+int max_capacity;						// Capacitat màxima de la classe o UNLIMITED.
+int heap_pos;							// Posició de la classe al heap del seu grau.
+LinkedList students;					// Estudiants de la classe, ordenats per login.
+SkipList by_login;						// Índex dels nodes de la llista per login.
+pthread_rwlock_t lock;					// Protegeix la llista de la classe.
 } Classroom;
 
 typedef struct {
-	char name[MAX_STRING_LENGTH]; 
+	long long count;					// Lectures que han hagut d'esperar un escriptor (atòmic).
+	long long total_ns;					// Temps total d'espera, en nanosegons (atòmic).
+	long long max_ns;					// Espera més llarga, en nanosegons (atòmic).
+} LockWaits;
+
+typedef struct {
+	StringId name; 
 	int num_classrooms; 
 	Classroom *classrooms;
+	int *heap;							// Posicions de les classes, la menys plena primer (min-heap).
+	OutputCache summary;				// Resum del grau (classes i capacitats) ja preparat.
+	OutputCache show;					// Estudiants del grau ja preparats per mostrar-los.
+	pthread_mutex_t cache_lock;			// Protegeix el resum i els estudiants ja preparats.
+	LockWaits waits;					// Esperes dels lectors als escriptors de les classes del grau.
 } Degree;
 
+typedef struct {
+	int degree_pos;						// Posició del grau de l'estudiant.
+	int classroom_pos;					// Posició de la classe on està l'estudiant.
+	ListNode node;						// Node de la llista de la classe on està l'estudiant.
+} StudentLocation;
+
+typedef struct {
+	Student student;
+	int degree_pos;						// Posició del grau on va l'estudiant.
+	int classroom_pos;					// Posició de la classe on va l'estudiant.
+	int order;							// Ordre de lectura, per mantenir l'ordre del fitxer dins de cada classe.
+} PendingStudent;
+
+typedef struct {
+	FILE *f;							// Fitxer del journal obert per afegir-hi moviments.
+	char *file_name;					// Nom del fitxer del journal.
+	char *target;						// Fitxer d'estudiants (o snapshot) on es compacta el journal.
+	int snapshot;						// Variable flag que val 1 si el fitxer on es compacta és un snapshot.
+	int pending;						// Moviments escrits que encara no s'han passat al disc.
+	int records;						// Moviments que hi ha al journal.
+} Journal;
+
+/*
+ * Accés concurrent: tots els canvis (càrrega, moviments, bulk moves) els fa un sol fil, que 
+ *  agafa per escriure el lock de les classes que modifica. Qualsevol altre fil pot mostrar 
+ *  el resum o els estudiants d'un grau (summaryOption i showDegree): agafa per llegir els locks 
+ *  de totes les classes del grau i recorre les llistes amb iteradors propis, sense tocar el 
+ *  POV. Així un lector sempre veu cada grau sencer abans o després d'un moviment, mai a mitges, 
+ *  però es bloqueja mentre un escriptor té alguna classe del grau: un moviment sol dura 
+ *  microsegons, però un bulk move té les classes que toca durant tota la fase d'aplicar-lo. 
+ *  Els lectors només no esperen si el grau ja està preparat (OutputCache). Les esperes es 
+ *  compten a cada grau (LockWaits) i la comanda stress les mostra.
+ */
 typedef struct { 
 	int num_degrees;
     Degree *elements;
+	NodePool pool;						// Pool d'on surten els nodes de totes les llistes d'estudiants.
+	StringTable strings;				// Taula amb tots els noms i logins, cadascun guardat un sol cop.
+	int *degree_of;						// Posició del grau de cada nom (indexat per StringId) o -1.
+	int num_degree_of;
+	int *location_of;					// Posició a l'array de localitzacions de cada login (indexat per StringId) o -1.
+	int max_location_of;
+	StudentLocation *locations;			// On es troba cada estudiant.
+	int num_locations;
+	int max_locations;
+	Journal *journal;					// Journal on s'apunten els moviments o NULL si no n'hi ha.
+	OutputCache summary;				// Resum de tots els graus, unió dels resums de cada grau.
+	pthread_mutex_t summary_lock;		// Protegeix el resum de tots els graus.
 } Degrees;
 
+typedef struct {
+	const char *pos;					// Caràcter que s'ha de llegir.
+	const char *end;					// Final del contingut del fitxer.
+	const char *line_start;				// Inici de la línia actual, per calcular la columna.
+	int line;							// Línia actual (la primera és la 1).
+	const char *file_name;				// Nom del fitxer, per als missatges d'error.
+	int error;							// Variable flag que val 1 si s'ha trobat un error de format.
+	int quiet;							// Variable flag que val 1 si els errors no s'han de mostrar.
+} Parser;
+
+typedef struct {
+	const char *name;					// Inici del nom dins del buffer del fitxer.
+	const char *login;					// Inici del login dins del buffer del fitxer.
+	int name_length;
+	int login_length;
+	const char *classroom;				// Inici del nom de la classe fixada dins del buffer (si n'hi ha).
+	int classroom_length;				// Longitud del nom de la classe fixada o 0 si no n'hi ha.
+	int degree_pos;						// Posició del grau on va l'estudiant.
+	Student student;					// Identificadors del nom i del login a la taula de noms.
+	int preferred;						// Posició de la classe fixada o -1 si no en té.
+	int classroom_pos;					// Posició de la classe que li ha tocat.
+	ListNode node;						// Node de l'estudiant a la llista de la classe.
+} ParsedStudent;
+
+typedef struct {
+	Parser parser;						// Analitzador del tros del fitxer (comença a l'inici d'un estudiant).
+	const char *chunk_end;				// Inici del tros següent, on s'acaba aquest.
+	Degrees *d;							// Estructura de graus, el fil només la consulta.
+	ParsedStudent *students;			// Estudiants llegits del tros, en l'ordre del fitxer.
+	int num_students;
+	int max_students;
+	long bytes;							// Caràcters de tots els noms i logins del tros.
+} LoadChunk;
+
+typedef struct {
+	Degrees *d;							// Estructura de graus (el fil només toca les classes dels seus graus).
+	LoadChunk *chunks;					// Trossos del fitxer, en l'ordre del fitxer.
+	int num_chunks;
+	int shard;							// El fil reparteix els graus de posició shard, shard + num_shards...
+	int num_shards;
+	NodePool pool;						// Pool local del fil, d'on surten els nodes dels seus estudiants.
+} LoadShard;
+
+/*
+ * Format d'un fitxer snapshot: la capçalera i després, un darrere l'altre,
+ *  num_degrees SnapshotDegree, num_classrooms SnapshotClassroom (en ordre de grau),
+ *  num_students Student (en ordre de classe i de llista) i el bloc de textos de la 
+ *  taula de noms. Tots els enters estan alineats a 4 bytes, així que els estudiants 
+ *  es poden afegir a les llistes directament des del fitxer mapejat.
+ */
+typedef struct {
+	char magic[8];						// SNAPSHOT_MAGIC.
+	int version;						// SNAPSHOT_VERSION.
+	unsigned int checksum;				// Hash FNV-1a de tot el que hi ha després de la capçalera.
+	long long payload_size;				// Bytes que hi ha després de la capçalera.
+	int num_degrees;
+	int num_classrooms;					// Nombre total de classes de tots els graus.
+	long long num_students;
+	long long strings_bytes;			// Bytes del bloc de textos de la taula de noms.
+} SnapshotHeader;
+
+typedef struct {
+	StringId name;
+	int num_classrooms;
+} SnapshotDegree;
+
+typedef struct {
+	StringId name;
+	int max_capacity;
+	int num_students;
+} SnapshotClassroom;
+
+typedef struct {
+	int degree_pos;						// Posició del grau de l'estudiant.
+	int classroom_pos;					// Posició de la classe on és ara l'estudiant (origen).
+	int location;						// Posició de l'estudiant a l'array de localitzacions.
+} BulkMove;
+
+typedef struct {
+	Degrees *d;
+	const int *totals;					// Estudiants de cada grau (els moviments no els canvien).
+	const int *done;					// Variable flag que val 1 quan s'acaben els moviments (atòmica).
+	int *seen;							// Última lectura on ha sortit cada login (indexat per StringId).
+	int stamp;							// Número de la lectura actual.
+	unsigned int seed;					// Estat dels nombres aleatoris del fil.
+	long long reads;					// Graus llegits.
+	long long inconsistent;				// Lectures que no quadren amb el nombre d'estudiants del grau.
+} StressReader;
+
+typedef struct {
+	StringId login;
+	int degree_pos;						// Posició del grau de l'estudiant.
+} StressStudent;
+
 /*********************************************** 
 *
 * @Finalitat: Comprovar si s'ha obert correctament un fitxer.
 
 * @Paràmetres: in/out: correct = punter a enter on s'emmagatzema el valor que determina si el fitxe és correcte (1/0)
-			   in: f = punter que conté la direcció del fitxer obert	
+			   in: f = fitxer mapejat a memòria (NULL si no s'ha pogut obrir)	
 * @Retorn: ----
 *
 * **********************************************/
-void correctFile(int *correct, FILE *f){
+void correctFile(int *correct, MappedFile f){
 	// Comprova si el fitxer s'ha llegit correctament.
 	if(f == NULL){
 		*correct = 0;
@@ -56,378 +238,3160 @@ void correctFile(int *correct, FILE *f){
 
 /*********************************************** 
 *
-* @Finalitat: Llgir el primer fitxer i a la vegada crear l'estructura desitjada a la memòria.
+* @Finalitat: Preparar un analitzador per llegir el contingut d'un fitxer mapejat a memòria.
+			  Els camps es llegeixen directament del buffer del fitxer, sense copiar-los.
 
-* @Paràmetres: in: f1 = Punter a FILE que conté la direcció del fitxer obert
-			   in/out: d = Punter a Punter a Degree que permet modificar el contingut de "d" fora del main.
+* @Paràmetres: in/out: p = Punter a Parser a inicialitzar.
+			   in: f = fitxer mapejat a memòria.
+			   in: file_name = nom del fitxer, per als missatges d'error.
+* @Retorn: ----
+*
+* **********************************************/
+void parserInit(Parser *p, MappedFile f, const char file_name[]){
+	p->pos = MAPPEDFILE_data(f);
+	p->end = p->pos + MAPPEDFILE_size(f);
+	p->line_start = p->pos;
+	p->line = 1;
+	p->file_name = file_name;
+	p->error = 0;
+	p->quiet = 0;
+}
+
+/*********************************************** 
+*
+* @Finalitat: Mostrar l'error de format amb la línia i la columna on s'ha trobat.
+			  Només es mostra el primer error de cada fitxer, i cap si l'analitzador és silenciós.
+
+* @Paràmetres: in/out: p = Punter a Parser que ha trobat l'error.
+			   in: expected = descripció del que s'esperava trobar.
 * @Retorn: ----
 *
 * **********************************************/
-void readFileOne(FILE *f1, Degrees **d){
-	int i = 0, j= 0;						// Variables per als bucles for.
-	char trash;								// Variable de tipus caracter per netejar el buffer.
+void parserError(Parser *p, const char expected[]){
+	if(!p->error && !p->quiet){
+		printf("\nERROR: Wrong format in '%s' (line %d, column %d): expected %s\n", p->file_name, p->line, (int) (p->pos - p->line_start) + 1, expected);
+	}
+	p->error = 1;
+}
 
-	//Llegeixo el numero de graus que hi ha al fitxer.
-	fscanf(f1, "%d", &((*d)->num_degrees));
-	//Netejo el buffer per evitar errors.
-	fscanf(f1, "%c", &trash);
-	
-	// Reservo memòria per a la quantitat de graus llegida anteriorment.
-	(*d)->elements = (Degree *) malloc(sizeof(Degree)*((*d)->num_degrees));
+/*********************************************** 
+*
+* @Finalitat: Avançar l'analitzador per sobre dels espais de la línia actual (sense canviar de línia).
+* @Paràmetres: in/out: p = Punter a Parser.
+* @Retorn: ----
+*
+* **********************************************/
+void skipSpaces(Parser *p){
+	while(p->pos < p->end && (*p->pos == ' ' || *p->pos == '\t' || *p->pos == '\r')){
+		p->pos++;
+	}
+}
 
-	// Faig un bucle while per a llegir tota la informació de tots els graus de fitxer.
-	while(i < ((*d)->num_degrees)){
-		// LLegeixo la informació del grau.
-		fscanf(f1, "%d", &((*d)->elements[i].num_classrooms));
-		fscanf(f1, "%c", &trash);
-		fgets((*d)->elements[i].name, MAX_STRING_LENGTH, f1);
-		// Elimino el \n.
-		(*d)->elements[i].name[strlen((*d)->elements[i].name)-1] = '\0';
+/*********************************************** 
+*
+* @Finalitat: Avançar l'analitzador per sobre dels espais i dels salts de línia.
+* @Paràmetres: in/out: p = Punter a Parser.
+* @Retorn: ----
+*
+* **********************************************/
+void skipBlank(Parser *p){
+	skipSpaces(p);
+	while(p->pos < p->end && *p->pos == '\n'){
+		p->pos++;
+		p->line++;
+		p->line_start = p->pos;
+		skipSpaces(p);
+	}
+}
+
+/*********************************************** 
+*
+* @Finalitat: Llegir un nombre enter no negatiu, saltant els espais i salts de línia anteriors.
 
-		// Reservo memòria per a la quantitat de classes llegida anteriorment.
-		(*d)->elements[i].classrooms = (Classroom *) malloc(sizeof(Classroom)*((*d)->elements[i].num_classrooms));
+* @Paràmetres: in/out: p = Punter a Parser.
+			   in/out: value = Punter a enter on es guarda el nombre llegit.
+* @Retorn: 1 si s'ha llegit el nombre o 0 si el format no és correcte.
+*
+* **********************************************/
+int parseNumber(Parser *p, int *value){
+	int correct = 0;					// Variable que valdrà 1 si s'ha llegit algun dígit.
+
+	skipBlank(p);
+	*value = 0;
+	while(p->pos < p->end && *p->pos >= '0' && *p->pos <= '9'){
+		*value = *value*10 + (*p->pos - '0');
+		p->pos++;
+		correct = 1;
+	}
+	if(!correct){
+		parserError(p, "a number");
+	}
+	return(correct);
+}
 
-		//Faig un bucle for per llegir la informació de les classes.
-		for(j=0;j<((*d)->elements[i].num_classrooms);j++){
-			fscanf(f1, "%s", (*d)->elements[i].classrooms[j].name); 
+/*********************************************** 
+*
+* @Finalitat: Llegir una paraula (fins al següent espai o salt de línia), saltant els 
+			  espais i salts de línia anteriors.
+
+* @Paràmetres: in/out: p = Punter a Parser.
+			   in/out: text = Punter on es guarda l'inici de la paraula dins del buffer.
+			   in/out: length = Punter a enter on es guarda la longitud de la paraula.
+			   in: expected = descripció de la paraula, per al missatge d'error.
+* @Retorn: 1 si s'ha llegit la paraula o 0 si el format no és correcte.
+*
+* **********************************************/
+int parseWord(Parser *p, const char **text, int *length, const char expected[]){
+	skipBlank(p);
+	*text = p->pos;
+	while(p->pos < p->end && *p->pos != ' ' && *p->pos != '\t' && *p->pos != '\r' && *p->pos != '\n'){
+		p->pos++;
+	}
+	*length = (int) (p->pos - *text);
+	if(*length == 0){
+		parserError(p, expected);
+	}
+	return(*length > 0);
+}
 
-			// Creo una llista de usuaris per a cada classe.
-			(*d)->elements[i].classrooms[j].students = LINKEDLIST_create();
+/*********************************************** 
+*
+* @Finalitat: Llegir un camp de la línia actual fins a un separador (que es salta) o, si 
+			  el separador és '\n', fins al final de la línia. S'eliminen els espais del 
+			  principi i del final del camp.
+
+* @Paràmetres: in/out: p = Punter a Parser.
+			   in: separator = caràcter que acaba el camp.
+			   in/out: text = Punter on es guarda l'inici del camp dins del buffer.
+			   in/out: length = Punter a enter on es guarda la longitud del camp.
+			   in: expected = descripció del camp, per al missatge d'error.
+* @Retorn: 1 si s'ha llegit el camp o 0 si el format no és correcte.
+*
+* **********************************************/
+int parseField(Parser *p, char separator, const char **text, int *length, const char expected[]){
+	const char *last;					// Posició després de l'últim caràcter del camp que no és un espai.
+
+	skipSpaces(p);
+	*text = p->pos;
+	last = p->pos;
+	while(p->pos < p->end && *p->pos != separator && *p->pos != '\n'){
+		if(*p->pos != ' ' && *p->pos != '\t' && *p->pos != '\r'){
+			last = p->pos + 1;
+		}
+		p->pos++;
+	}
+	*length = (int) (last - *text);
+
+	if(*length == 0){
+		parserError(p, expected);
+	}
+	else if(separator != '\n' && (p->pos == p->end || *p->pos != separator)){
+		parserError(p, separator == ',' ? "','" : "a separator");
+	}
+	else if(p->pos < p->end && separator != '\n'){
+		p->pos++;
+	}
+	return(!p->error);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Comprovar que no hi ha res més a la línia actual i passar a la següent.
+* @Paràmetres: in/out: p = Punter a Parser.
+* @Retorn: 1 si la línia s'acaba o 0 si el format no és correcte.
+*
+* **********************************************/
+int parseEndOfLine(Parser *p){
+	skipSpaces(p);
+	if(p->pos < p->end && *p->pos != '\n'){
+		parserError(p, "end of line");
+	}
+	else if(p->pos < p->end){
+		p->pos++;
+		p->line++;
+		p->line_start = p->pos;
+	}
+	return(!p->error);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Llegir un camp opcional fins al final de la línia actual (sense passar a la següent).
+
+* @Paràmetres: in/out: p = Punter a Parser.
+			   in/out: text = Punter on es guarda l'inici del camp dins del buffer.
+			   in/out: length = Punter a enter on es guarda la longitud del camp (0 si no n'hi ha).
+* @Retorn: 1 si el format és correcte (amb camp o sense), 0 en cas contrari.
+*
+* **********************************************/
+int parseOptionalField(Parser *p, const char **text, int *length){
+	skipSpaces(p);
+	*text = p->pos;
+	*length = 0;
+	if(p->pos < p->end && *p->pos != '\n'){
+		parseField(p, '\n', text, length, "a field");
+	}
+	return(!p->error);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Saltar la resta de la línia actual (per continuar després d'un error de format).
+* @Paràmetres: in/out: p = Punter a Parser.
+* @Retorn: ----
+*
+* **********************************************/
+void parserSkipLine(Parser *p){
+	while(p->pos < p->end && *p->pos != '\n'){
+		p->pos++;
+	}
+	p->error = 0;
+	parseEndOfLine(p);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Comprovar si s'ha arribat al final del fitxer, saltant els espais i salts de línia.
+* @Paràmetres: in/out: p = Punter a Parser.
+* @Retorn: 1 si no queda res més per llegir, 0 en cas contrari.
+*
+* **********************************************/
+int parserAtEnd(Parser *p){
+	skipBlank(p);
+	return(p->pos >= p->end);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Deixar buida una sortida preparada, sense memòria reservada.
+* @Paràmetres: in/out: cache = Punter a la sortida preparada.
+* @Retorn: ----
+*
+* **********************************************/
+void cacheInit(OutputCache *cache){
+	cache->text = NULL;
+	cache->length = 0;
+	cache->max_length = 0;
+	cache->valid = 0;
+}
+
+/*********************************************** 
+*
+* @Finalitat: Afegir text amb format (com printf) al final d'una sortida preparada. El buffer 
+			  es dobla quan no hi cap, així que es reaprofita d'un cop per l'altre.
+
+* @Paràmetres: in/out: cache = Punter a la sortida preparada.
+			   in: format = format del text, com a printf.
+* @Retorn: ----
+*
+* **********************************************/
+void cacheAppend(OutputCache *cache, const char format[], ...){
+	va_list args;						// Arguments del format.
+	int length = 0;						// Longitud del text que s'afegeix.
+	char *aux;							// Buffer nou quan el text no hi cap.
+
+	va_start(args, format);
+	length = vsnprintf(cache->text + cache->length, cache->max_length - cache->length, format, args);
+	va_end(args);
+
+	if(length >= cache->max_length - cache->length){
+		// No hi cap: faig créixer el buffer i torno a escriure el text.
+		aux = (char *) realloc(cache->text, 2*(cache->length + length + 1) + 256);
+		if(aux != NULL){
+			cache->text = aux;
+			cache->max_length = 2*(cache->length + length + 1) + 256;
+			va_start(args, format);
+			vsnprintf(cache->text + cache->length, cache->max_length - cache->length, format, args);
+			va_end(args);
+		}
+		else{
+			length = 0;
+		}
+	}
+	cache->length += length;
+}
+
+/*********************************************** 
+*
+* @Finalitat: Alliberar la memòria d'una sortida preparada.
+* @Paràmetres: in/out: cache = Punter a la sortida preparada.
+* @Retorn: ----
+*
+* **********************************************/
+void cacheFree(OutputCache *cache){
+	free(cache->text);
+	cacheInit(cache);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Apuntar que un grau ha canviat (capacitats o llistes), perquè el resum i els 
+			  estudiants es tornin a preparar el proper cop que es demanin. El fil que fa el 
+			  canvi ha de tenir encara el lock de les classes que ha modificat.
+
+* @Paràmetres: in/out: d = Punter a Degrees on està emmagatzemada tota la informació.
+			   in: degree_pos = posició del grau que ha canviat.
+* @Retorn: ----
+*
+* **********************************************/
+void degreeChanged(Degrees *d, int degree_pos){
+	// Els lectors consulten les variables sense el lock de les classes, per això són atòmiques. 
+	// El resum de tots els graus s'invalida l'últim, després del del grau.
+	__atomic_store_n(&(d->elements[degree_pos].summary.valid), 0, __ATOMIC_SEQ_CST);
+	__atomic_store_n(&(d->elements[degree_pos].show.valid), 0, __ATOMIC_SEQ_CST);
+	__atomic_store_n(&(d->summary.valid), 0, __ATOMIC_SEQ_CST);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Apuntar a les esperes d'un grau que un lector ha esperat un escriptor.
+* @Paràmetres: in/out: waits = Punter a les esperes del grau.
+			   in: ns = temps d'espera, en nanosegons.
+* @Retorn: ----
+*
+* **********************************************/
+void countWait(LockWaits *waits, long long ns){
+	long long max = __atomic_load_n(&(waits->max_ns), __ATOMIC_RELAXED);
+
+	__atomic_fetch_add(&(waits->count), 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&(waits->total_ns), ns, __ATOMIC_RELAXED);
+	while(ns > max && !__atomic_compare_exchange_n(&(waits->max_ns), &max, ns, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+/*********************************************** 
+*
+* @Finalitat: Agafar el lock de totes les classes d'un grau, en ordre de posició (tots els fils 
+			  els agafen en el mateix ordre, així no es poden bloquejar entre ells). Si un lector 
+			  ha d'esperar un escriptor, el temps d'espera es compta a les esperes del grau.
+
+* @Paràmetres: in/out: degree = Punter al grau.
+			   in: write = 1 per agafar-los per escriure, 0 per llegir.
+* @Retorn: ----
+*
+* **********************************************/
+void lockClassrooms(Degree *degree, int write){
+	int i = 0;							// Variable per al bucle for.
+	struct timespec start, end;			// Inici i final de l'espera d'un lector.
+	long long waited = 0;				// Temps que ha esperat el lector, en nanosegons.
+
+	for(i=0;i<degree->num_classrooms;i++){
+		if(write){
+			pthread_rwlock_wrlock(&(degree->classrooms[i].lock));
+		}
+		else if(pthread_rwlock_tryrdlock(&(degree->classrooms[i].lock)) != 0){
+			// Un escriptor té la classe: el lector s'hi espera.
+			clock_gettime(CLOCK_MONOTONIC, &start);
+			pthread_rwlock_rdlock(&(degree->classrooms[i].lock));
+			clock_gettime(CLOCK_MONOTONIC, &end);
+			waited += (end.tv_sec - start.tv_sec)*1000000000LL + (end.tv_nsec - start.tv_nsec);
+		}
+	}
+	if(waited > 0){
+		countWait(&(degree->waits), waited);
+	}
+}
+
+/*********************************************** 
+*
+* @Finalitat: Deixar el lock de totes les classes d'un grau.
+* @Paràmetres: in/out: degree = Punter al grau.
+* @Retorn: ----
+*
+* **********************************************/
+void unlockClassrooms(Degree *degree){
+	int i = 0;							// Variable per al bucle for.
+
+	for(i=0;i<degree->num_classrooms;i++){
+		pthread_rwlock_unlock(&(degree->classrooms[i].lock));
+	}
+}
+
+/*********************************************** 
+*
+* @Finalitat: Agafar per escriure el lock de les classes marcades d'un grau, en ordre de posició 
+			  com la funció lockClassrooms.
+
+* @Paràmetres: in/out: degree = Punter al grau.
+			   in: marked = array amb un 1 per a cada classe que s'ha de bloquejar i un 0 per a la resta.
+* @Retorn: ----
+*
+* **********************************************/
+void lockMarkedClassrooms(Degree *degree, const char marked[]){
+	int i = 0;							// Variable per al bucle for.
+
+	for(i=0;i<degree->num_classrooms;i++){
+		if(marked[i]){
+			pthread_rwlock_wrlock(&(degree->classrooms[i].lock));
+		}
+	}
+}
+
+/*********************************************** 
+*
+* @Finalitat: Deixar el lock de les classes marcades d'un grau i treure'n les marques.
+* @Paràmetres: in/out: degree = Punter al grau.
+			   in/out: marked = array amb un 1 per a cada classe bloquejada, queda tot a 0.
+* @Retorn: ----
+*
+* **********************************************/
+void unlockMarkedClassrooms(Degree *degree, char marked[]){
+	int i = 0;							// Variable per al bucle for.
+
+	for(i=0;i<degree->num_classrooms;i++){
+		if(marked[i]){
+			pthread_rwlock_unlock(&(degree->classrooms[i].lock));
+			marked[i] = 0;
+		}
+	}
+}
+
+/*********************************************** 
+*
+* @Finalitat: Calcular els estudiants que té una classe comptant els canvis que encara no s'han 
+			  fet a la llista: els estudiants assignats mentre es carrega un fitxer, que s'afegeixen 
+			  en grups, i els moviments validats d'un moviment massiu, que es fan al final.
+* @Paràmetres: in: classroom = Punter a la classe.
+* @Retorn: Nombre d'estudiants de la classe.
+*
+* **********************************************/
+int classroomLoad(Classroom *classroom){
+	return(LINKEDLIST_size(classroom->students) + classroom->staged);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Comprovar si una classe està plena.
+* @Paràmetres: in: classroom = Punter a la classe.
+* @Retorn: 1 si la classe no admet més estudiants, 0 en cas contrari.
+*
+* **********************************************/
+int isFull(Classroom *classroom){
+	return(classroom->max_capacity != UNLIMITED && classroomLoad(classroom) >= classroom->max_capacity);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Comparar dues classes d'un grau per saber quina ha de rebre abans els estudiants: 
+			  primer les que no estan plenes, després les que tenen menys estudiants (o, si totes dues 
+			  són plenes, menys estudiants per sobre de la capacitat) i, a igualtat, la de posició més petita.
+
+* @Paràmetres: in: degree = Punter al grau de les classes.
+			   in: a = posició de la primera classe.
+			   in: b = posició de la segona classe.
+* @Retorn: 1 si la classe a va abans que la b, 0 en cas contrari.
+*
+* **********************************************/
+int lessLoaded(Degree *degree, int a, int b){
+	Classroom *ca = &(degree->classrooms[a]);
+	Classroom *cb = &(degree->classrooms[b]);
+	int load_a = classroomLoad(ca), load_b = classroomLoad(cb);		// Estudiants que es comparen.
+	int result = 0;
+
+	if(isFull(ca) != isFull(cb)){
+		result = !isFull(ca);
+	}
+	else{
+		if(isFull(ca)){
+			load_a -= ca->max_capacity;
+			load_b -= cb->max_capacity;
+		}
+		if(load_a != load_b){
+			result = load_a < load_b;
+		}
+		else{
+			result = a < b;
+		}
+	}
+	return(result);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Intercanviar dues posicions del heap de classes d'un grau.
+* @Paràmetres: in/out: degree = Punter al grau.
+			   in: i, j = posicions del heap a intercanviar.
+* @Retorn: ----
+*
+* **********************************************/
+void heapSwap(Degree *degree, int i, int j){
+	int aux = degree->heap[i];
+
+	degree->heap[i] = degree->heap[j];
+	degree->heap[j] = aux;
+	degree->classrooms[degree->heap[i]].heap_pos = i;
+	degree->classrooms[degree->heap[j]].heap_pos = j;
+}
+
+/*********************************************** 
+*
+* @Finalitat: Pujar una posició del heap mentre vagi abans que el seu pare.
+* @Paràmetres: in/out: degree = Punter al grau.
+			   in: i = posició del heap a pujar.
+* @Retorn: Posició final al heap.
+*
+* **********************************************/
+int heapSiftUp(Degree *degree, int i){
+	while(i > 0 && lessLoaded(degree, degree->heap[i], degree->heap[(i-1)/2])){
+		heapSwap(degree, i, (i-1)/2);
+		i = (i-1)/2;
+	}
+	return(i);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Tornar a col·locar al heap una classe que ha canviat de nombre d'estudiants, 
+			  pujant-la o baixant-la fins que el heap torna a estar ordenat. O(log k).
+
+* @Paràmetres: in/out: degree = Punter al grau.
+			   in: classroom_pos = posició de la classe que ha canviat.
+* @Retorn: ----
+*
+* **********************************************/
+void heapUpdate(Degree *degree, int classroom_pos){
+	int i = degree->classrooms[classroom_pos].heap_pos;		// Posició actual al heap.
+	int child = 0;											// Fill amb menys estudiants.
+	int moved = 0;											// Variable flag que val 1 si la classe ja està al seu lloc.
+
+	// Si té menys estudiants que el seu pare, la pujo.
+	moved = (heapSiftUp(degree, i) != i);
+	// Si no ha pujat, potser té més estudiants que algun fill i s'ha de baixar.
+	while(!moved && 2*i+1 < degree->num_classrooms){
+		child = 2*i+1;
+		if(child+1 < degree->num_classrooms && lessLoaded(degree, degree->heap[child+1], degree->heap[child])){
+			child++;
+		}
+		if(lessLoaded(degree, degree->heap[child], degree->heap[i])){
+			heapSwap(degree, i, child);
+			i = child;
+		}
+		else{
+			moved = 1;
+		}
+	}
+}
+
+/*********************************************** 
+*
+* @Finalitat: Escollir la classe d'un grau on va un nou estudiant: la classe fixada al fitxer si 
+			  encara té lloc o, si no, la menys plena que encara té lloc (el primer element del heap). 
+			  Si totes són plenes, l'estudiant va a la que en té menys, i el resum ho mostra per 
+			  sobre de la capacitat. La classe escollida ja compta l'estudiant.
+
+* @Paràmetres: in/out: d = Punter a Degrees on està emmagatzemada tota la informació.
+			   in: degree_pos = posició del grau de l'estudiant.
+			   in: preferred = posició de la classe fixada per a l'estudiant o -1 si no en té.
+* @Retorn: Posició de la classe on va l'estudiant.
+*
+* **********************************************/
+int assignClassroom(Degrees *d, int degree_pos, int preferred){
+	Degree *degree = &(d->elements[degree_pos]);
+	int classroom_pos = degree->heap[0];
+
+	if(preferred != -1 && !isFull(&(degree->classrooms[preferred]))){
+		classroom_pos = preferred;
+	}
+
+	degree->classrooms[classroom_pos].staged++;
+	heapUpdate(degree, classroom_pos);
+	degreeChanged(d, degree_pos);
+	return(classroom_pos);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Comparar dos estudiants pel seu login (ordre de les llistes de les classes).
+
+* @Paràmetres: in: a = punter al primer estudiant.
+			   in: b = punter al segon estudiant.
+			   in: strings = taula de noms on hi ha els logins.
+* @Retorn: Enter negatiu, zero o positiu si a va abans, igual o després de b.
+*
+* **********************************************/
+int compareLogins(const Student *a, const Student *b, void *strings){
+	int result = 0;
+
+	if(a->login != b->login){
+		result = strcmp(STRINGTABLE_get((StringTable) strings, a->login), STRINGTABLE_get((StringTable) strings, b->login));
+	}
+	return(result);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Crear el heap de classes d'un grau afegint les classes una a una 
+			  (les de capacitat 0 ja estan plenes).
+* @Paràmetres: in/out: degree = Punter al grau.
+* @Retorn: ----
+*
+* **********************************************/
+void buildHeap(Degree *degree){
+	int j = 0;							// Variable per al bucle for.
+
+	for(j=0;j<degree->num_classrooms;j++){
+		degree->heap[j] = j;
+		degree->classrooms[j].heap_pos = j;
+		heapSiftUp(degree, j);
+	}
+}
+
+/*********************************************** 
+*
+* @Finalitat: Crear l'índex de graus: per a cada nom de la taula, la posició del seu grau (o -1).
+* @Paràmetres: in/out: d = Punter a Degrees amb els graus ja creats.
+* @Retorn: ----
+*
+* **********************************************/
+void buildDegreeIndex(Degrees *d){
+	int i = 0;							// Variable per als bucles for.
+
+	// L'índex només ha d'arribar fins al nom de grau més gran.
+	d->num_degree_of = 0;
+	for(i=0;i<d->num_degrees;i++){
+		if(d->elements[i].name >= d->num_degree_of){
+			d->num_degree_of = d->elements[i].name + 1;
+		}
+	}
+	d->degree_of = (int *) malloc(sizeof(int)*(d->num_degree_of + 1));
+	for(i=0;i<d->num_degree_of;i++){
+		d->degree_of[i] = -1;
+	}
+	for(i=0;i<d->num_degrees;i++){
+		d->degree_of[d->elements[i].name] = i;
+	}
+}
+
+/*********************************************** 
+*
+* @Finalitat: Llgir el primer fitxer i a la vegada crear l'estructura desitjada a la memòria.
+			  El fitxer es llegeix directament del buffer mapejat, en una sola passada.
+
+* @Paràmetres: in: f1 = fitxer mapejat a memòria.
+			   in: file_name = nom del fitxer, per als missatges d'error.
+			   in/out: d = Punter a Punter a Degree que permet modificar el contingut de "d" fora del main.
+* @Retorn: correct = 1 si el fitxer té el format correcte, 0 si no (l'estructura queda a mig 
+		   crear però es pot alliberar amb la funció dealocation).
+*
+* **********************************************/
+int readFileOne(MappedFile f1, const char file_name[], Degrees **d){
+	int i = 0, j= 0;						// Variables per als bucles.
+	Parser p;								// Analitzador del contingut del fitxer.
+	const char *text;						// Inici del camp llegit dins del buffer.
+	int length = 0;							// Longitud del camp llegit.
+	int num_degrees = 0;					// Nombre de graus que indica el fitxer.
+	Degree *degree;							// Punter auxiliar al grau que s'està llegint.
+
+	METRICS_START(TIMER_READ_FILE_ONE);
+
+	parserInit(&p, f1, file_name);
+
+	//Llegeixo el numero de graus que hi ha al fitxer.
+	if(parseNumber(&p, &num_degrees) && num_degrees == 0){
+		parserError(&p, "at least one degree");
+	}
+	
+	// Reservo memòria per a la quantitat de graus llegida anteriorment.
+	(*d)->elements = (Degree *) malloc(sizeof(Degree)*(num_degrees > 0 ? num_degrees : 1));
+	(*d)->num_degrees = 0;
+
+	// Creo el pool de nodes que compartiran totes les llistes d'estudiants.
+	(*d)->pool = LINKEDLIST_createPool();
+	// Creo la taula de noms i l'índex de logins buit, s'omplirà a mesura que s'afegeixin estudiants.
+	(*d)->strings = STRINGTABLE_create(num_degrees*3);
+	(*d)->location_of = NULL;
+	(*d)->max_location_of = 0;
+	(*d)->locations = NULL;
+	(*d)->num_locations = 0;
+	(*d)->max_locations = 0;
+	(*d)->journal = NULL;
+	cacheInit(&((*d)->summary));
+	pthread_mutex_init(&((*d)->summary_lock), NULL);
+
+	// Faig un bucle while per a llegir tota la informació de tots els graus de fitxer.
+	while(!p.error && i < num_degrees){
+		degree = &((*d)->elements[i]);
+
+		// LLegeixo la informació del grau: el nombre de classes i el nom fins al final de la línia.
+		if(parseNumber(&p, &(degree->num_classrooms)) && degree->num_classrooms == 0){
+			parserError(&p, "at least one classroom");
+		}
+		if(!p.error && parseField(&p, '\n', &text, &length, "the degree name")){
+			// Guardo el nom a la taula de noms directament des del buffer.
+			degree->name = STRINGTABLE_internN((*d)->strings, text, length);
+
+			// Reservo memòria per a la quantitat de classes llegida anteriorment i el seu heap.
+			degree->classrooms = (Classroom *) malloc(sizeof(Classroom)*(degree->num_classrooms));
+			degree->heap = (int *) malloc(sizeof(int)*(degree->num_classrooms));
+
+			//Faig un bucle for per llegir la informació de les classes: el nom i, opcionalment, 
+			//la capacitat màxima a la mateixa línia.
+			for(j=0;j<degree->num_classrooms && parseWord(&p, &text, &length, "a classroom name");j++){
+				degree->classrooms[j].name = STRINGTABLE_internN((*d)->strings, text, length);
+				degree->classrooms[j].staged = 0;
+				degree->classrooms[j].max_capacity = UNLIMITED;
+				skipSpaces(&p);
+				if(p.pos < p.end && *p.pos >= '0' && *p.pos <= '9'){
+					parseNumber(&p, &(degree->classrooms[j].max_capacity));
+				}
+
+				// Creo una llista de usuaris per a cada classe amb els nodes del pool, i el seu índex.
+				degree->classrooms[j].students = LINKEDLIST_createWithPool((*d)->pool);
+				degree->classrooms[j].by_login = SKIPLIST_create(compareLogins, (*d)->strings);
+				pthread_rwlock_init(&(degree->classrooms[j].lock), NULL);
+			}
+			// Si el fitxer s'acaba abans d'hora, el grau només té les classes creades.
+			degree->num_classrooms = j;
+			cacheInit(&(degree->summary));
+			cacheInit(&(degree->show));
+			pthread_mutex_init(&(degree->cache_lock), NULL);
+			memset(&(degree->waits), 0, sizeof(LockWaits));
+			(*d)->num_degrees++;
+
+			// Creo el heap de les classes del grau.
+			buildHeap(degree);
+		}
+		i++;
+	}
+
+	// Creo l'índex de graus.
+	buildDegreeIndex(*d);
+
+	METRICS_STOP(TIMER_READ_FILE_ONE);
+	return(!p.error);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Obtenir la posició del grau que té un nom de la taula de noms.
+
+* @Paràmetres: in: d = Punter a Degrees on està emmagatzemada tota la informació.
+			   in: name = identificador del nom a la taula de noms (o STRING_NOT_FOUND).
+* @Retorn: Posició del grau a l'array dinàmica o -1 si el nom no és de cap grau.
+*
+* **********************************************/
+int degreeOf(Degrees *d, StringId name){
+	int pos = -1;						// Posició del grau.
+
+	if(name >= 0 && name < d->num_degree_of){
+		pos = d->degree_of[name];
+	}
+	return(pos);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Cerca la posició en la que es troba el grau que introdueix l'usuari.
+			  La classe de l'estudiant l'escull després la funció assignClassroom.
+
+* @Paràmetres: in: degree = inici del nom del grau (no cal que acabi amb '\0').
+			   in: length = longitud del nom del grau.
+			   in: d = Punter a Degrees on està emmagatzemada tota la informació.
+
+* @Retorn: pos_degree = posició de l'array dinàmica on es troba el grau del estudiant.
+*
+* **********************************************/
+int searchPosition(const char degree[], int length, Degrees **d){
+	int pos_degree = 0;					// Posició de l'array dinàmica on està el grau introduit.
+
+	// Consulto l'índex per trobar la posició del grau a l'array dinàmica. Només es llegeix
+	// la taula de noms, així que es pot cridar des de diversos fils a la vegada.
+	pos_degree = degreeOf(*d, STRINGTABLE_lookupN((*d)->strings, degree, length));
+	// Si el grau no existeix, l'estudiant es guarda al primer grau com fins ara.
+	if(pos_degree == -1){
+		pos_degree = 0;
+	}
+
+	return(pos_degree);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Obtenir la posició d'una classe d'un grau a partir del seu nom.
+
+* @Paràmetres: in: d = Punter a Degrees on es troba la direcció de tota la estructura creada previament.
+			   in: degree_pos = posició del grau.
+			   in: name = inici del nom de la classe (no cal que acabi amb '\0').
+			   in: length = longitud del nom de la classe.
+* @Retorn: Posició de la classe al grau o -1 si el grau no té cap classe amb aquest nom.
+*
+* **********************************************/
+int findClassroom(Degrees *d, int degree_pos, const char name[], int length){
+	StringId id = STRINGTABLE_findN(d->strings, name, length);		// Identificador del nom a la taula de noms.
+	int pos = -1;													// Posició de la classe.
+	int i = 0;														// Variable per al bucle for.
+
+	for(i=0;id != STRING_NOT_FOUND && pos == -1 && i<d->elements[degree_pos].num_classrooms;i++){
+		if(d->elements[degree_pos].classrooms[i].name == id){
+			pos = i;
+		}
+	}
+	return(pos);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Guardar a l'índex de logins on es troba un estudiant. Si el login 
+			  ja hi era, se n'actualitza la localització.
+
+* @Paràmetres: in/out: d = Punter a Degrees on està emmagatzemada tota la informació.
+			   in: login = identificador del login de l'estudiant a la taula de noms.
+			   in: degree_pos = posició del grau de l'estudiant.
+			   in: classroom_pos = posició de la classe de l'estudiant.
+			   in: node = node de la llista de la classe on està l'estudiant.
+* @Retorn: ----
+*
+* **********************************************/
+void indexLogin(Degrees *d, StringId login, int degree_pos, int classroom_pos, ListNode node){
+	int pos = 0;						// Posició a l'array de localitzacions.
+
+	// Si el login és més nou que l'índex, faig créixer l'índex fins a la mida de la taula de noms.
+	if(login >= d->max_location_of){
+		pos = d->max_location_of;
+		d->max_location_of = STRINGTABLE_size(d->strings)*2;
+		d->location_of = (int *) realloc(d->location_of, sizeof(int)*d->max_location_of);
+		while(pos < d->max_location_of){
+			d->location_of[pos] = -1;
+			pos++;
+		}
+	}
+
+	pos = d->location_of[login];
+	if(pos == -1){
+		// Si l'array de localitzacions està ple, en dupliquem la mida.
+		if(d->num_locations == d->max_locations){
+			d->max_locations = (d->max_locations == 0) ? 64 : d->max_locations*2;
+			d->locations = (StudentLocation *) realloc(d->locations, sizeof(StudentLocation)*d->max_locations);
+		}
+		pos = d->num_locations;
+		d->num_locations++;
+		d->location_of[login] = pos;
+	}
+	d->locations[pos].degree_pos = degree_pos;
+	d->locations[pos].classroom_pos = classroom_pos;
+	d->locations[pos].node = node;
+}
+
+/*********************************************** 
+*
+* @Finalitat: Afegir de cop un grup d'estudiants al final de la llista d'una classe 
+			  i registrar-los a l'índex de logins.
+
+* @Paràmetres: in/out: d = Punter a Degrees on està emmagatzemada tota la informació.
+			   in: students = array amb els estudiants a afegir.
+			   in: n = nombre d'estudiants de l'array.
+			   in: degree_pos = posició del grau dels estudiants.
+			   in: classroom_pos = posició de la classe on s'afegeixen els estudiants.
+			   in/out: nodes = array de n posicions on es guarden els nodes dels estudiants.
+* @Retorn: ----
+*
+* **********************************************/
+void addStudents(Degrees *d, const Student students[], int n, int degree_pos, int classroom_pos, ListNode nodes[]){
+	int i = 0;							// Variable per al bucle for.
+
+	// La llista afegeix els estudiants després del seu últim node, sense recórrer-la.
+	LINKEDLIST_appendMany(d->elements[degree_pos].classrooms[classroom_pos].students, students, n, nodes);
+
+	for(i=0;i<n;i++){
+		indexLogin(d, students[i].login, degree_pos, classroom_pos, nodes[i]);
+	}
+	degreeChanged(d, degree_pos);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Ordenar per login les llistes de totes les classes d'un grau i tornar a crear-ne 
+			  els índexs per login en una passada. Els nodes no canvien, així que l'índex de logins 
+			  continua sent vàlid, i les llistes que ja estan ordenades només es recorren un cop.
+
+* @Paràmetres: in/out: d = Punter a Degrees on està emmagatzemada tota la informació.
+			   in: degree_pos = posició del grau.
+* @Retorn: ----
+*
+* **********************************************/
+void sortRosters(Degrees *d, int degree_pos){
+	int j = 0;							// Variable per al bucle for.
+	Classroom *classroom;				// Classe que s'està ordenant.
+	const Student *student;				// Estudiant de la llista ordenada.
+	ListIterator iterator;				// Posició del recorregut de la llista.
+
+	for(j=0;j<d->elements[degree_pos].num_classrooms;j++){
+		classroom = &(d->elements[degree_pos].classrooms[j]);
+		LINKEDLIST_sort(classroom->students, compareLogins, d->strings);
+		SKIPLIST_clear(classroom->by_login);
+		LINKEDLIST_FOREACH_READ(classroom->students, iterator, student){
+			SKIPLIST_append(classroom->by_login, *student, LINKEDLIST_iteratorNode(&iterator));
+		}
+	}
+	degreeChanged(d, degree_pos);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Comparar dos estudiants pendents per grau, classe i ordre de lectura (per a qsort).
+
+* @Paràmetres: in: a = punter al primer estudiant pendent.
+			   in: b = punter al segon estudiant pendent.
+* @Retorn: Enter negatiu, zero o positiu si a va abans, igual o després de b.
+*
+* **********************************************/
+int comparePending(const void *a, const void *b){
+	const PendingStudent *pa = (const PendingStudent *) a;
+	const PendingStudent *pb = (const PendingStudent *) b;
+	int result = 0;
+
+	if(pa->degree_pos != pb->degree_pos){
+		result = pa->degree_pos - pb->degree_pos;
+	}
+	else if(pa->classroom_pos != pb->classroom_pos){
+		result = pa->classroom_pos - pb->classroom_pos;
+	}
+	else{
+		result = pa->order - pb->order;
+	}
+	return(result);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Afegir a les llistes els estudiants llegits pendents. S'agrupen per classe 
+			  i cada grup s'afegeix de cop amb la funció addStudents.
+
+* @Paràmetres: in/out: d = Punter a Degrees on està emmagatzemada tota la informació.
+			   in/out: pending = array amb els estudiants pendents.
+			   in: num_pending = nombre d'estudiants pendents.
+			   in/out: batch = array auxiliar de LOAD_BATCH estudiants.
+			   in/out: nodes = array auxiliar de LOAD_BATCH nodes.
+* @Retorn: ----
+*
+* **********************************************/
+void flushStudents(Degrees *d, PendingStudent pending[], int num_pending, Student batch[], ListNode nodes[]){
+	int i = 0;							// Variable per al bucle while.
+	int n = 0;							// Nombre d'estudiants del grup actual.
+
+	// Ordeno els pendents per classe mantenint l'ordre del fitxer dintre de cada una.
+	qsort(pending, num_pending, sizeof(PendingStudent), comparePending);
+
+	while(i < num_pending){
+		// Agrupo tots els estudiants consecutius de la mateixa classe.
+		n = 0;
+		do{
+			batch[n] = pending[i+n].student;
+			n++;
+		}while(i+n < num_pending && pending[i+n].degree_pos == pending[i].degree_pos && pending[i+n].classroom_pos == pending[i].classroom_pos);
+
+		// Ara els estudiants ja són a la llista, la càrrega de la classe no canvia.
+		addStudents(d, batch, n, pending[i].degree_pos, pending[i].classroom_pos, nodes);
+		d->elements[pending[i].degree_pos].classrooms[pending[i].classroom_pos].staged -= n;
+		i += n;
+	}
+}
+
+/*********************************************** 
+*
+* @Finalitat: Guardar un estudiant llegit com a pendent a la classe que li assigna la funció 
+			  assignClassroom i, si ja n'hi ha prou, afegir-los tots a les llistes amb la funció flushStudents.
+
+* @Paràmetres: in/out: d = Punter a Degrees on està emmagatzemada tota la informació.
+			   in: student = estudiant llegit.
+			   in: degree_pos = posició del grau de l'estudiant.
+			   in: preferred = posició de la classe fixada per a l'estudiant o -1 si no en té.
+			   in/out: pending = array amb els estudiants pendents.
+			   in/out: num_pending = Punter al nombre d'estudiants pendents.
+			   in/out: batch = array auxiliar de LOAD_BATCH estudiants.
+			   in/out: nodes = array auxiliar de LOAD_BATCH nodes.
+* @Retorn: ----
+*
+* **********************************************/
+void stageStudent(Degrees *d, Student student, int degree_pos, int preferred, PendingStudent pending[], int *num_pending, Student batch[], ListNode nodes[]){
+	pending[*num_pending].student = student;
+	pending[*num_pending].degree_pos = degree_pos;
+	// Escullo ara la classe, en l'ordre del fitxer, perquè el repartiment no depengui dels lots.
+	pending[*num_pending].classroom_pos = assignClassroom(d, degree_pos, preferred);
+	pending[*num_pending].order = *num_pending;
+	(*num_pending)++;
+	if(*num_pending == LOAD_BATCH){
+		flushStudents(d, pending, *num_pending, batch, nodes);
+		*num_pending = 0;
+	}
+}
+
+/*********************************************** 
+*
+* @Finalitat: Llegir el segon fitxer amb els estudiants i emmagatzemar-lo a la memòria de forma ordenada.
+			  El fitxer es llegeix directament del buffer mapejat, en una sola passada.
+
+* @Paràmetres: in: f2 = fitxer mapejat a memòria.
+			   in: file_name = nom del fitxer, per als missatges d'error.
+			   in/out: d = punter a Punter a Degree que permet modificar el contingut de "d" fora del main.
+* @Retorn: correct = 1 si el fitxer té el format correcte, 0 si no (es guarden els estudiants 
+		   llegits abans de l'error).
+*
+* **********************************************/
+int readFileTwo(MappedFile f2, const char file_name[], Degrees **d){
+	Parser p;										// Analitzador del contingut del fitxer.
+	const char *name, *degree, *login, *classroom;	// Inici de cada camp dins del buffer.
+	int name_length = 0, degree_length = 0, login_length = 0, classroom_length = 0;	// Longitud de cada camp.
+	int pos_degree = 0;								// Variable on es guardrà la posició del grau.
+	Student aux_student;							// Variable auxiliar per a llegir els estudiants de la llista
+	PendingStudent *pending;						// Estudiants llegits pendents d'afegir a les llistes.
+	int num_pending = 0;							// Nombre d'estudiants pendents.
+	Student *batch;									// Array auxiliar per afegir els estudiants de cop.
+	ListNode *nodes;								// Array auxiliar on es guarden els nodes dels estudiants afegits.
+
+	METRICS_START(TIMER_READ_FILE_TWO);
+
+	// Reservo memòria per als estudiants pendents i els arrays auxiliars.
+	pending = (PendingStudent *) malloc(sizeof(PendingStudent)*LOAD_BATCH);
+	batch = (Student *) malloc(sizeof(Student)*LOAD_BATCH);
+	nodes = (ListNode *) malloc(sizeof(ListNode)*LOAD_BATCH);
+
+	parserInit(&p, f2, file_name);
+
+	// Faig un bucle while per llegir el fitxer fins que aquest acabi. Cada estudiant 
+	// són dues línies: "nom, grau" i "login", opcionalment seguit de la classe on està fixat.
+	while(!parserAtEnd(&p)
+		&& parseField(&p, ',', &name, &name_length, "the student name")
+		&& parseField(&p, '\n', &degree, &degree_length, "the degree name")
+		&& parseEndOfLine(&p)
+		&& parseWord(&p, &login, &login_length, "the student login")
+		&& parseOptionalField(&p, &classroom, &classroom_length)
+		&& parseEndOfLine(&p)){
+
+		// Guardo el nom i el login a la taula de noms directament des del buffer; l'estudiant només en guarda els identificadors.
+		aux_student.name = STRINGTABLE_internN((*d)->strings, name, name_length);
+		aux_student.login = STRINGTABLE_internN((*d)->strings, login, login_length);
+
+		// Crido a la funció search position per trobar la posició del grau de l'estudiant.
+		pos_degree = searchPosition(degree, degree_length, d);
+
+		// Guardo l'estudiant com a pendent i, si ja n'hi ha prou, els afegeixo tots a les llistes.
+		stageStudent(*d, aux_student, pos_degree, classroom_length > 0 ? findClassroom(*d, pos_degree, classroom, classroom_length) : -1,
+			pending, &num_pending, batch, nodes);
+	}
+
+	// Afegeixo els últims estudiants pendents.
+	flushStudents(*d, pending, num_pending, batch, nodes);
+
+	free(pending);
+	free(batch);
+	free(nodes);
+
+	METRICS_STOP(TIMER_READ_FILE_TWO);
+	return(!p.error);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Trobar l'inici del primer estudiant a partir d'una posició qualsevol del fitxer. 
+			  Cada estudiant comença amb la línia "nom, grau" (l'única amb una coma), 
+			  seguida de la línia amb el login.
+
+* @Paràmetres: in: pos = posició a partir de la qual es cerca.
+			   in: begin = inici del contingut del fitxer.
+			   in: end = final del contingut del fitxer.
+* @Retorn: Posició on comença el primer estudiant a partir de pos (o end si no n'hi ha cap).
+*
+* **********************************************/
+const char *recordStart(const char *pos, const char *begin, const char *end){
+	const char *line;					// Inici de la línia que s'està comprovant.
+	int comma = 0;						// Variable flag que val 1 si la línia té una coma.
+
+	// Vaig fins a l'inici de la línia següent (si no som ja a l'inici d'una línia).
+	while(pos > begin && pos < end && pos[-1] != '\n'){
+		pos++;
+	}
+	// Salto les línies en blanc i la línia del login, si el tros comença a mig estudiant.
+	while(pos < end && !comma){
+		line = pos;
+		while(pos < end && *pos != '\n'){
+			if(*pos == ','){
+				comma = 1;
+			}
+			pos++;
+		}
+		if(comma){
+			pos = line;
+		}
+		else if(pos < end){
+			pos++;
+		}
+	}
+	return(pos);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Llegir tots els estudiants d'un tros del fitxer (funció de cada fil). Els estudiants 
+			  es guarden a l'array del tros sense tocar la taula de noms ni les llistes, de manera 
+			  que els fils no es bloquegen mai entre ells.
+
+* @Paràmetres: in/out: arg = Punter al LoadChunk que ha de llegir el fil.
+* @Retorn: NULL
+*
+* **********************************************/
+void *parseChunk(void *arg){
+	LoadChunk *chunk = (LoadChunk *) arg;	// Tros que llegeix el fil.
+	Parser *p = &(chunk->parser);			// Analitzador del tros.
+	ParsedStudent student;					// Estudiant llegit.
+	ParsedStudent *students;				// Punter auxiliar per fer créixer l'array d'estudiants.
+	const char *degree;						// Inici del nom del grau dins del buffer.
+	int degree_length = 0;					// Longitud del nom del grau.
+
+	while(!parserAtEnd(p) && p->pos < chunk->chunk_end
+		&& parseField(p, ',', &student.name, &student.name_length, "the student name")
+		&& parseField(p, '\n', &degree, &degree_length, "the degree name")
+		&& parseEndOfLine(p)
+		&& parseWord(p, &student.login, &student.login_length, "the student login")
+		&& parseOptionalField(p, &student.classroom, &student.classroom_length)
+		&& parseEndOfLine(p)){
+
+		student.degree_pos = searchPosition(degree, degree_length, &(chunk->d));
+
+		// Si l'array està ple, en dupliquem la mida.
+		if(chunk->num_students == chunk->max_students){
+			chunk->max_students = (chunk->max_students == 0) ? 1024 : chunk->max_students*2;
+			students = (ParsedStudent *) realloc(chunk->students, sizeof(ParsedStudent)*chunk->max_students);
+			if(students == NULL){
+				// Sense memòria el tros no es pot llegir, es tracta com un error.
+				p->error = 1;
+				break;
+			}
+			chunk->students = students;
+		}
+		chunk->students[chunk->num_students] = student;
+		chunk->num_students++;
+		chunk->bytes += student.name_length + student.login_length;
+	}
+	return(NULL);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Repartir a les classes els estudiants dels graus d'un fil (funció de cada fil). 
+			  Es recorren tots els trossos en l'ordre del fitxer, i cada estudiant d'un grau del 
+			  fil es guarda a la llista del fil per a la seva classe, amb un node del pool local. 
+			  Al final cada llista del fil s'enganxa al final de la de la classe sense recórrer-la. 
+			  Cap altre fil toca les classes, els heaps ni el pool local d'aquests graus, així que 
+			  no cal cap lock.
+
+* @Paràmetres: in/out: arg = Punter al LoadShard amb els graus del fil.
+* @Retorn: NULL
+*
+* **********************************************/
+void *stageShard(void *arg){
+	LoadShard *shard = (LoadShard *) arg;	// Graus que reparteix el fil.
+	Degrees *d = shard->d;					// Estructura de graus.
+	LinkedList **staging;					// Llistes del fil per a cada classe dels seus graus.
+	ParsedStudent *student;					// Estudiant que s'està repartint.
+	Classroom *classroom;					// Classe on s'enganxa la llista del fil.
+	int i = 0, j = 0;						// Variables per als bucles for.
+
+	// Creo una llista buida amb el pool local per a cada classe dels graus del fil.
+	staging = (LinkedList **) calloc(d->num_degrees, sizeof(LinkedList *));
+	for(i=shard->shard;i<d->num_degrees;i+=shard->num_shards){
+		staging[i] = (LinkedList *) malloc(sizeof(LinkedList)*d->elements[i].num_classrooms);
+		for(j=0;j<d->elements[i].num_classrooms;j++){
+			staging[i][j] = LINKEDLIST_createWithPool(shard->pool);
+		}
+	}
+
+	// Escullo la classe de cada estudiant en l'ordre del fitxer, com la funció readFileTwo.
+	for(i=0;i<shard->num_chunks;i++){
+		for(j=0;j<shard->chunks[i].num_students;j++){
+			student = &(shard->chunks[i].students[j]);
+			if(student->degree_pos % shard->num_shards == shard->shard){
+				student->classroom_pos = assignClassroom(d, student->degree_pos, student->preferred);
+				LINKEDLIST_appendMany(staging[student->degree_pos][student->classroom_pos], &(student->student), 1, &(student->node));
+			}
+		}
+	}
+
+	// Enganxo cada llista del fil al final de la de la classe: ara els estudiants ja són a la 
+	// llista, la càrrega de la classe no canvia.
+	for(i=shard->shard;i<d->num_degrees;i+=shard->num_shards){
+		for(j=0;j<d->elements[i].num_classrooms;j++){
+			classroom = &(d->elements[i].classrooms[j]);
+			classroom->staged -= LINKEDLIST_size(staging[i][j]);
+			LINKEDLIST_appendList(classroom->students, staging[i][j]);
+			LINKEDLIST_release(&(staging[i][j]));
+		}
+		free(staging[i]);
+	}
+	free(staging);
+	return(NULL);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Llegir el segon fitxer amb diversos fils. El fitxer es divideix en trossos que 
+			  comencen a l'inici d'un estudiant i cada fil en llegeix un. Després els noms i els 
+			  logins es guarden a la taula de noms en l'ordre del fitxer (en aquest fil) i els 
+			  estudiants es reparteixen a les classes amb un fil per grup de graus (stageShard), 
+			  també en l'ordre del fitxer, de manera que les llistes queden igual que amb la 
+			  funció readFileTwo. Si algun tros té un error de format, el fitxer es torna a 
+			  llegir amb readFileTwo per mostrar-lo.
+
+* @Paràmetres: in: f2 = fitxer mapejat a memòria.
+			   in: file_name = nom del fitxer, per als missatges d'error.
+			   in/out: d = punter a Punter a Degree que permet modificar el contingut de "d" fora del main.
+			   in: num_threads = nombre de fils que llegeixen el fitxer.
+* @Retorn: correct = 1 si el fitxer té el format correcte, 0 si no.
+*
+* **********************************************/
+int readFileTwoParallel(MappedFile f2, const char file_name[], Degrees **d, int num_threads){
+	const char *data = MAPPEDFILE_data(f2);			// Contingut del fitxer.
+	const char *end = data + MAPPEDFILE_size(f2);	// Final del contingut del fitxer.
+	LoadChunk *chunks;								// Trossos del fitxer, un per fil.
+	LoadShard *shards;								// Grups de graus, un per fil.
+	int num_shards = 0;								// Nombre de fils que reparteixen els estudiants.
+	pthread_t *threads;								// Fils que llegeixen els trossos.
+	int *started;									// Variable flag per fil que val 1 si s'ha pogut crear.
+	int correct = 1;								// Variable que valdrà 0 si algun tros no s'ha pogut llegir.
+	int i = 0, j = 0;								// Variables per als bucles for.
+	int total = 0;									// Nombre total d'estudiants llegits.
+	long bytes = 0;									// Caràcters de tots els noms i logins.
+	ParsedStudent *student;							// Estudiant que s'està guardant.
+
+	METRICS_START(TIMER_READ_FILE_TWO);
+
+	chunks = (LoadChunk *) malloc(sizeof(LoadChunk)*num_threads);
+	threads = (pthread_t *) malloc(sizeof(pthread_t)*num_threads);
+	started = (int *) malloc(sizeof(int)*num_threads);
+
+	// Divideixo el fitxer en trossos de la mateixa mida que comencen a l'inici d'un estudiant.
+	for(i=0;i<num_threads;i++){
+		parserInit(&(chunks[i].parser), f2, file_name);
+		chunks[i].parser.quiet = 1;
+		chunks[i].parser.pos = recordStart(data + (end - data)*i/num_threads, data, end);
+		chunks[i].parser.line_start = chunks[i].parser.pos;
+		chunks[i].d = *d;
+		chunks[i].students = NULL;
+		chunks[i].num_students = 0;
+		chunks[i].max_students = 0;
+		chunks[i].bytes = 0;
+	}
+	for(i=0;i<num_threads;i++){
+		chunks[i].chunk_end = (i+1 < num_threads) ? chunks[i+1].parser.pos : end;
+	}
+
+	// Llegeixo els trossos en paral·lel. Si no es pot crear un fil, el tros el llegeix aquest mateix fil.
+	for(i=0;i<num_threads;i++){
+		started[i] = (pthread_create(&threads[i], NULL, parseChunk, &chunks[i]) == 0);
+		if(!started[i]){
+			parseChunk(&chunks[i]);
+		}
+	}
+	for(i=0;i<num_threads;i++){
+		if(started[i]){
+			pthread_join(threads[i], NULL);
+		}
+		// Cada tros s'ha d'acabar just on comença el següent.
+		if(chunks[i].parser.error || chunks[i].parser.pos != chunks[i].chunk_end){
+			correct = 0;
+		}
+		total += chunks[i].num_students;
+		bytes += chunks[i].bytes;
+	}
+
+	if(correct){
+		// Faig lloc a la taula de noms per a tots els noms i logins, perquè no hagi de créixer.
+		STRINGTABLE_reserve((*d)->strings, total*2, bytes);
+
+		// Guardo els noms i els logins en l'ordre del fitxer, perquè els identificadors siguin 
+		// els mateixos que amb la funció readFileTwo, i busco la classe fixada de cada estudiant.
+		for(i=0;i<num_threads;i++){
+			for(j=0;j<chunks[i].num_students;j++){
+				student = &(chunks[i].students[j]);
+				student->student.name = STRINGTABLE_internN((*d)->strings, student->name, student->name_length);
+				student->student.login = STRINGTABLE_internN((*d)->strings, student->login, student->login_length);
+				student->preferred = student->classroom_length > 0 
+					? findClassroom(*d, student->degree_pos, student->classroom, student->classroom_length) : -1;
+			}
+		}
+
+		// Reparteixo els estudiants amb un fil per grup de graus, cadascun amb el seu pool de nodes.
+		num_shards = ((*d)->num_degrees < num_threads) ? (*d)->num_degrees : num_threads;
+		shards = (LoadShard *) malloc(sizeof(LoadShard)*num_shards);
+		for(i=0;i<num_shards;i++){
+			shards[i].d = *d;
+			shards[i].chunks = chunks;
+			shards[i].num_chunks = num_threads;
+			shards[i].shard = i;
+			shards[i].num_shards = num_shards;
+			shards[i].pool = LINKEDLIST_createLocalPool((*d)->pool);
+			started[i] = (shards[i].pool != NULL && pthread_create(&threads[i], NULL, stageShard, &shards[i]) == 0);
+		}
+		// Si no es pot crear un fil, els seus graus els reparteix aquest mateix fil (els altres fils 
+		// no fan servir el pool de totes les llistes fins que s'hi torna el seu).
+		for(i=0;i<num_shards;i++){
+			if(!started[i]){
+				if(shards[i].pool == NULL){
+					shards[i].pool = (*d)->pool;
+				}
+				stageShard(&shards[i]);
+			}
+		}
+		for(i=0;i<num_shards;i++){
+			if(started[i]){
+				pthread_join(threads[i], NULL);
+			}
+		}
+		// Els nodes de cada fil passen al pool de totes les llistes.
+		for(i=0;i<num_shards;i++){
+			if(shards[i].pool != (*d)->pool){
+				LINKEDLIST_mergePool(&(shards[i].pool));
+			}
+		}
+		free(shards);
+
+		// Guardo on és cada estudiant en l'ordre del fitxer (si un login es repeteix, compta l'últim).
+		for(i=0;i<num_threads;i++){
+			for(j=0;j<chunks[i].num_students;j++){
+				student = &(chunks[i].students[j]);
+				indexLogin(*d, student->student.login, student->degree_pos, student->classroom_pos, student->node);
+			}
+		}
+		for(i=0;i<(*d)->num_degrees;i++){
+			degreeChanged(*d, i);
+		}
+	}
+
+	for(i=0;i<num_threads;i++){
+		free(chunks[i].students);
+	}
+	free(chunks);
+	free(threads);
+	free(started);
+	METRICS_STOP(TIMER_READ_FILE_TWO);
+
+	// Si algun tros no s'ha pogut llegir, no s'ha afegit cap estudiant: el torno a llegir 
+	// sencer amb readFileTwo, que mostra l'error i guarda els estudiants anteriors.
+	if(!correct){
+		correct = readFileTwo(f2, file_name, d);
+	}
+	return(correct);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Comprovar si un fitxer mapejat és una exportació CSV (comença per CSV_HEADER).
+* @Paràmetres: in: f = fitxer mapejat a memòria.
+* @Retorn: 1 si el fitxer és un CSV exportat, 0 en cas contrari.
+*
+* **********************************************/
+int isCsv(MappedFile f){
+	long length = strlen(CSV_HEADER);			// Longitud de la capçalera.
+
+	return(MAPPEDFILE_size(f) >= length && memcmp(MAPPEDFILE_data(f), CSV_HEADER, length) == 0);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Llegir un camp d'una línia CSV fins a la coma (que es salta) o fins al final de la 
+			  línia. Si el camp està entre cometes, pot tenir comes i cometes dobles (""); en aquest 
+			  cas es copia sense les cometes dobles a scratch.
+
+* @Paràmetres: in/out: p = Punter a Parser.
+			   in/out: scratch = buffer de CSV_FIELD_LENGTH caràcters per als camps amb cometes dobles.
+			   in/out: text = Punter on es guarda l'inici del camp (al buffer del fitxer o a scratch).
+			   in/out: length = Punter a enter on es guarda la longitud del camp.
+			   in: expected = descripció del camp, per al missatge d'error.
+* @Retorn: 1 si s'ha llegit un camp no buit, 0 si el format no és correcte.
+*
+* **********************************************/
+int parseCsvField(Parser *p, char scratch[], const char **text, int *length, const char expected[]){
+	int copied = 0;						// Variable flag que val 1 si el camp s'ha copiat a scratch.
+
+	*text = p->pos;
+	*length = 0;
+	if(p->pos < p->end && *p->pos == '"'){
+		p->pos++;
+		*text = p->pos;
+		while(!p->error && p->pos < p->end && !(*p->pos == '"' && (p->pos+1 >= p->end || p->pos[1] != '"'))){
+			if(*p->pos == '"' && !copied){
+				// Primera cometa doble: copio el que porto de camp a scratch.
+				if(*length < CSV_FIELD_LENGTH){
+					memcpy(scratch, *text, *length);
+				}
+				copied = 1;
+			}
+			if(*length >= CSV_FIELD_LENGTH){
+				parserError(p, "a shorter field");
+			}
+			else if(copied){
+				scratch[*length] = *p->pos;
+			}
+			p->pos += (*p->pos == '"') ? 2 : 1;
+			(*length)++;
+		}
+		if(!p->error && p->pos >= p->end){
+			parserError(p, "'\"'");
+		}
+		else if(!p->error){
+			p->pos++;
+		}
+		if(copied){
+			*text = scratch;
+		}
+	}
+	else{
+		while(p->pos < p->end && *p->pos != ',' && *p->pos != '\n' && *p->pos != '\r'){
+			p->pos++;
+		}
+		*length = (int) (p->pos - *text);
+	}
+
+	if(!p->error && *length == 0){
+		parserError(p, expected);
+	}
+	else if(!p->error && p->pos < p->end && *p->pos == ','){
+		p->pos++;
+	}
+	return(!p->error);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Llegir els estudiants d'una exportació CSV ("grau,classe,login,nom" a cada línia, 
+			  després de la capçalera). Cada estudiant es fixa a la classe del fitxer, de manera 
+			  que la distribució exportada es recupera tal com era.
+
+* @Paràmetres: in: f2 = fitxer mapejat a memòria.
+			   in: file_name = nom del fitxer, per als missatges d'error.
+			   in/out: d = punter a Punter a Degree que permet modificar el contingut de "d" fora del main.
+* @Retorn: correct = 1 si el fitxer té el format correcte, 0 si no (es guarden els estudiants 
+		   llegits abans de l'error).
+*
+* **********************************************/
+int readFileCsv(MappedFile f2, const char file_name[], Degrees **d){
+	Parser p;										// Analitzador del contingut del fitxer.
+	const char *degree, *classroom, *login, *name;	// Inici de cada camp.
+	int degree_length = 0, classroom_length = 0, login_length = 0, name_length = 0;	// Longitud de cada camp.
+	char degree_copy[CSV_FIELD_LENGTH], classroom_copy[CSV_FIELD_LENGTH];			// Camps amb cometes dobles.
+	char login_copy[CSV_FIELD_LENGTH], name_copy[CSV_FIELD_LENGTH];
+	int pos_degree = 0;								// Variable on es guardrà la posició del grau.
+	Student aux_student;							// Variable auxiliar per a llegir els estudiants.
+	PendingStudent *pending;						// Estudiants llegits pendents d'afegir a les llistes.
+	int num_pending = 0;							// Nombre d'estudiants pendents.
+	Student *batch;									// Array auxiliar per afegir els estudiants de cop.
+	ListNode *nodes;								// Array auxiliar on es guarden els nodes dels estudiants afegits.
+
+	METRICS_START(TIMER_READ_FILE_TWO);
+
+	pending = (PendingStudent *) malloc(sizeof(PendingStudent)*LOAD_BATCH);
+	batch = (Student *) malloc(sizeof(Student)*LOAD_BATCH);
+	nodes = (ListNode *) malloc(sizeof(ListNode)*LOAD_BATCH);
+
+	// Salto la capçalera.
+	parserInit(&p, f2, file_name);
+	parserSkipLine(&p);
+
+	while(!parserAtEnd(&p)
+		&& parseCsvField(&p, degree_copy, &degree, &degree_length, "the degree name")
+		&& parseCsvField(&p, classroom_copy, &classroom, &classroom_length, "the classroom name")
+		&& parseCsvField(&p, login_copy, &login, &login_length, "the student login")
+		&& parseCsvField(&p, name_copy, &name, &name_length, "the student name")
+		&& parseEndOfLine(&p)){
+
+		aux_student.name = STRINGTABLE_internN((*d)->strings, name, name_length);
+		aux_student.login = STRINGTABLE_internN((*d)->strings, login, login_length);
+		pos_degree = searchPosition(degree, degree_length, d);
+		stageStudent(*d, aux_student, pos_degree, findClassroom(*d, pos_degree, classroom, classroom_length),
+			pending, &num_pending, batch, nodes);
+	}
+	flushStudents(*d, pending, num_pending, batch, nodes);
+
+	free(pending);
+	free(batch);
+	free(nodes);
+
+	METRICS_STOP(TIMER_READ_FILE_TWO);
+	return(!p.error);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Mostrar el nombre d'estudiants i la capacitat màxima d'una classe ("inf" si no en té).
+* @Paràmetres: in: classroom = Punter a la classe.
+* @Retorn: ----
+*
+* **********************************************/
+void printCapacity(Classroom *classroom){
+	if(classroom->max_capacity == UNLIMITED){
+		printf("%d/inf", LINKEDLIST_size(classroom->students));
+	}
+	else{
+		printf("%d/%d", LINKEDLIST_size(classroom->students), classroom->max_capacity);
+	}
+}
+
+/*********************************************** 
+*
+* @Finalitat: Preparar el resum d'un grau (les classes i les seves capacitats), si ha canviat 
+			  des de l'últim cop. S'ha de tenir el lock del resum ja preparat del grau.
+
+* @Paràmetres: in/out: d = Punter a Degrees on està emmagatzemada tota la informació.
+			   in: degree_pos = posició del grau.
+* @Retorn: Punter al resum del grau ja preparat.
+*
+* **********************************************/
+OutputCache *renderDegreeSummary(Degrees *d, int degree_pos){
+	int k = 0;							// Variable per al bucle for.
+	Degree *degree = &(d->elements[degree_pos]);
+	Classroom *classroom;				// Classe que s'està preparant.
+
+	if(!__atomic_load_n(&(degree->summary.valid), __ATOMIC_SEQ_CST)){
+		// Amb els locks de les classes cap moviment pot canviar el grau mentre es prepara. El 
+		// resum ja és vàlid: si un moviment l'invalida, serà després de deixar els locks.
+		lockClassrooms(degree, 0);
+		__atomic_store_n(&(degree->summary.valid), 1, __ATOMIC_SEQ_CST);
+		degree->summary.length = 0;
+		cacheAppend(&(degree->summary), "\n%s\n", STRINGTABLE_get(d->strings, degree->name));
+		for(k=0;k<degree->num_classrooms;k++){
+			classroom = &(degree->classrooms[k]);
+			if(classroom->max_capacity == UNLIMITED){
+				cacheAppend(&(degree->summary), "%s %d/inf\n", STRINGTABLE_get(d->strings, classroom->name), LINKEDLIST_size(classroom->students));
+			}
+			else{
+				cacheAppend(&(degree->summary), "%s %d/%d\n", STRINGTABLE_get(d->strings, classroom->name), LINKEDLIST_size(classroom->students), classroom->max_capacity);
+			}
+		}
+		unlockClassrooms(degree);
+	}
+	return(&(degree->summary));
+}
+
+/*********************************************** 
+*
+* @Finalitat: Preparar els estudiants d'un grau, si ha canviat des de l'últim cop. Les llistes 
+			  es recorren amb iteradors propis, sense tocar el POV. S'ha de tenir el lock dels 
+			  estudiants ja preparats del grau.
+
+* @Paràmetres: in/out: d = Punter a Degrees on està emmagatzemada tota la informació.
+			   in: degree_pos = posició del grau.
+* @Retorn: Punter als estudiants del grau ja preparats.
+*
+* **********************************************/
+OutputCache *renderDegreeShow(Degrees *d, int degree_pos){
+	int i = 0;									// Variable per al bucle for.
+	Degree *degree = &(d->elements[degree_pos]);
+	ListIterator iterator;						// Posició del recorregut de la llista.
+	const Student *aux_student;					// Punter auxiliar per a llegir els estudiants de la llista sense copiar-los.
+
+	if(!__atomic_load_n(&(degree->show.valid), __ATOMIC_SEQ_CST)){
+		lockClassrooms(degree, 0);
+		__atomic_store_n(&(degree->show.valid), 1, __ATOMIC_SEQ_CST);
+		degree->show.length = 0;
+		cacheAppend(&(degree->show), "\n");
+		for(i=0;i<degree->num_classrooms;i++){
+			LINKEDLIST_FOREACH_READ(degree->classrooms[i].students, iterator, aux_student){
+				cacheAppend(&(degree->show), "%s (%s): %s\n", STRINGTABLE_get(d->strings, aux_student->name), STRINGTABLE_get(d->strings, aux_student->login), STRINGTABLE_get(d->strings, degree->classrooms[i].name));
+			}
+		}
+		unlockClassrooms(degree);
+	}
+	return(&(degree->show));
+}
+
+/*********************************************** 
+*
+* @Finalitat: Preparar el resum de tots els graus, tornant a preparar només el dels graus que 
+			  han canviat. S'ha de tenir el lock del resum de tots els graus.
+
+* @Paràmetres: in/out: d = Punter a Degrees on està emmagatzemada tota la informació.
+* @Retorn: ----
+*
+* **********************************************/
+void renderSummary(Degrees *d){
+	int j = 0;							// Variable per al bucle for.
+	OutputCache *summary;				// Resum del grau.
+
+	if(!__atomic_load_n(&(d->summary.valid), __ATOMIC_SEQ_CST)){
+		// Si un grau canvia després de copiar-ne el resum, el resum de tots torna a ser invàlid.
+		__atomic_store_n(&(d->summary.valid), 1, __ATOMIC_SEQ_CST);
+		d->summary.length = 0;
+		for(j=0;j<d->num_degrees;j++){
+			pthread_mutex_lock(&(d->elements[j].cache_lock));
+			summary = renderDegreeSummary(d, j);
+			cacheAppend(&(d->summary), "%.*s", (int) summary->length, summary->text);
+			pthread_mutex_unlock(&(d->elements[j].cache_lock));
+		}
+	}
+}
+
+/*********************************************** 
+*
+* @Finalitat: Mostrar les dades llegides anteriorment de forma ordenada per graus.
+* @Paràmetres: in: d = Punter a degrees on es troba la direcció de tota la estructura creada previament.
+* @Retorn: ----
+*
+* **********************************************/
+void summaryOption(Degrees *d){
+	// Només es torna a preparar el resum dels graus que han canviat des de l'últim cop, i 
+	// després el mostro tot de cop.
+	pthread_mutex_lock(&(d->summary_lock));
+	renderSummary(d);
+	fwrite(d->summary.text, 1, d->summary.length, stdout);
+	pthread_mutex_unlock(&(d->summary_lock));
+}
+
+/*********************************************** 
+*
+* @Finalitat: Comprovar si el grau introduit per l'usuari està a la memòria i axtualitzar la seva posició.
+
+* @Paràmetres: in: d = Punter a degrees on es troba la direcció de tota la estructura creada previament.
+			   in: degree = cadena on està el nom del grau.
+			   in/out: degree_pos = Punter a enter on s'emmagatzema la direcció de la variable 
+			       que determina la posició on es situa el grau introduit per l'usuari.
+
+* @Retorn: correct = variable de tipus enter que valdrà 1 o 0 depenent si el grau introduit existeix a la memòria.
+*
+* **********************************************/
+int findDegree(Degrees *d, char degree[], int *degree_pos){
+	int correct = 0;			// Variable que valdrà 1 o 0 depenent si el grau introduit existeix a la memòria.
+	int pos = 0;				// Posició del grau segons l'índex.
+
+	METRICS_START(TIMER_FIND_DEGREE);
+	
+	// Consulto l'índex per comprovar que existeix el grau a la memòria i trobar la seva posició.
+	// STRINGTABLE_lookupN no canvia la taula, així diversos fils poden buscar graus alhora.
+	pos = degreeOf(d, STRINGTABLE_lookupN(d->strings, degree, strlen(degree)));
+	if(pos != -1){
+		correct = 1;
+		*degree_pos = pos;
+	}
+	METRICS_STOP(TIMER_FIND_DEGREE);
+	return(correct);
+}
+/*********************************************** 
+*
+* @Finalitat: Mostrar els estudiants d'un grau en cas que aquest existeixi.
+
+* @Paràmetres: in: d = Punter a degrees on es troba la direcció de tota la estructura creada previament.
+			   in: degree = cadena on està el nom del grau.
+* @Retorn: ----
+*
+* **********************************************/
+void showDegree(Degrees *d, char degree[]){
+	int degree_pos = 0;							// Variable on es guardarà la posició del grau.
+	Degree *aux_degree;							// Grau que es mostra.
+
+	//Comprovo si existeix el grau amb la funció findDegree.
+	if(findDegree(d, degree, &degree_pos)){
+		// Només es recorren les llistes si el grau ha canviat des de l'últim cop.
+		aux_degree = &(d->elements[degree_pos]);
+		pthread_mutex_lock(&(aux_degree->cache_lock));
+		renderDegreeShow(d, degree_pos);
+		fwrite(aux_degree->show.text, 1, aux_degree->show.length, stdout);
+		pthread_mutex_unlock(&(aux_degree->cache_lock));
+	}
+	else{
+		printf("\nERROR: Can't find degree\n");
+	}
+}
+/*********************************************** 
+*
+* @Finalitat: Preguntar al usuari quin grau vol veure la seva informació 
+			  i seguidament mostrar-la amb la funció showDegree en cas que aquest existeixi.
+
+* @Paràmetres: in: d = Punter a degrees on es troba la direcció de tota la estructura creada previament.
+* @Retorn: ----
+*
+* **********************************************/
+void showOption(Degrees *d){
+	char degree[MAX_STRING_LENGTH];				// Cadena on es guardarà el nom del grau.
+
+	// Obtinc el nom del grau sense \n.
+	printf("\nDegree to show? ");
+	fgets(degree, MAX_STRING_LENGTH-1, stdin);
+	degree[strlen(degree)-1] = '\0';
+	
+	// Crido la funció showDegree per mostrar els estudiants.
+	showDegree(d, degree);
+}
+/*********************************************** 
+*
+* @Finalitat: Comprova que hi ha algun estudiant del grau amb el login introduit 
+			  i actualitza les variables de la posició de la seva classe i el node 
+			  on es troba dintre la classe, consultant l'índex de logins.
+
+* @Paràmetres: in: login = cadena on està el login a cercar.
+			   in: d = Punter a Degrees on es troba la direcció de tota la estructura creada previament.
+			   in/out: classroom_pos = Punter a enter on s'emmagatzema la direcció de la variable 
+			       que determina la posició on es situa la classe del estudiant.
+			   in/out: node = Punter a ListNode on s'emmagatzema el node de la llista 
+			       de la classe on es troba l'estudiant.	
+			   in: degree_pos = posició de l'array dinàmica on està el grau on es vol cercar el login.
+
+* @Retorn: Retorna una variable de tipus int que val 1 o 0 depenent si s'ha trobat un estudiant amb el login introduït o no.
+*
+* **********************************************/
+int findLogin(char login[], Degrees *d, int *classroom_pos, ListNode *node, int degree_pos){
+	int correct = 0;				// Variable que valdrà 1 o 0 depenent si el login és correcte.
+	StringId id = 0;				// Identificador del login a la taula de noms.
+	int pos = -1;					// Posició a l'array de localitzacions.
+
+	METRICS_START(TIMER_FIND_LOGIN);
+
+	// Consulto l'índex i comprovo que l'estudiant és del grau indicat.
+	id = STRINGTABLE_find(d->strings, login);
+	if(id != STRING_NOT_FOUND && id < d->max_location_of){
+		pos = d->location_of[id];
+	}
+	if(pos != -1 && d->locations[pos].degree_pos == degree_pos){
+		// Actualitzo la posició de la seva classe desreferenciant el punter.
+		*classroom_pos = d->locations[pos].classroom_pos;
+		// Actualitzo el node dintre de la classe desreferenciant el punter.
+		*node = d->locations[pos].node;
+
+		correct = 1;
+	}
+	METRICS_STOP(TIMER_FIND_LOGIN);
+	return(correct);
+}
+/*********************************************** 
+*
+* @Finalitat: Apuntar un moviment al journal (si n'hi ha). El moviment queda al buffer del fitxer 
+			  i es passa al disc amb la resta del lot a la funció journalCommit.
+
+* @Paràmetres: in/out: d = Punter a Degrees on es troba la direcció de tota la estructura creada previament.
+			   in: login = identificador del login de l'estudiant.
+			   in: classroom = identificador del nom de la classe destí.
+* @Retorn: ----
+*
+* **********************************************/
+void journalRecord(Degrees *d, StringId login, StringId classroom){
+	if(d->journal != NULL && d->journal->f != NULL){
+		fprintf(d->journal->f, "%s %s\n", STRINGTABLE_get(d->strings, login), STRINGTABLE_get(d->strings, classroom));
+		d->journal->pending++;
+		d->journal->records++;
+	}
+}
+/*********************************************** 
+*
+* @Finalitat: Passar el node d'un estudiant de la llista d'una classe a la d'una altra, a la 
+			  posició que li toca per login, i actualitzar els índexs per login de les dues 
+			  classes. El node ja sap quin node té davant i l'índex de la classe destí diu on va, 
+			  així que no es recorre cap llista. S'ha de tenir per escriure el lock de les dues classes.
+
+* @Paràmetres: in/out: from = Punter a la classe on és l'estudiant.
+			   in/out: to = Punter a la classe on va l'estudiant.
+			   in: node = node de l'estudiant a la llista de la classe from.
+* @Retorn: Estudiant que s'ha mogut.
+*
+* **********************************************/
+Student spliceStudent(Classroom *from, Classroom *to, ListNode node){
+	ListIterator source, target;		// Posició de l'estudiant a la classe origen i on va a la classe destí.
+	Student student;					// Estudiant que es mou.
+
+	LINKEDLIST_iterateAtNode(from->students, node, &source);
+	student = LINKEDLIST_iteratorGet(&source);
+	LINKEDLIST_iterateAfterNode(to->students, SKIPLIST_findBefore(to->by_login, &student), &target);
+
+	// El node passa a la nova classe sense copiar l'estudiant.
+	LINKEDLIST_iteratorSpliceTo(&source, &target);
+	SKIPLIST_remove(from->by_login, &student);
+	SKIPLIST_insert(to->by_login, student, node);
+	return(student);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Moure un estudiant d'un grau a una altra classe del mateix grau, sempre que 
+			  la informació sigui correcta i la classe destí no estigui plena.
+
+* @Paràmetres: in/out: d = Punter a Degrees on es troba la direcció de tota la estructura creada previament.
+			   in: degree_pos = posició de l'array dinàmica on està el grau de l'estudiant.
+			   in: login = cadena on està el login de l'estudiant.
+			   in: index = índex (a partir de 1) de la classe a la que es vol moure l'estudiant.
+* @Retorn: correct = 1 si s'ha mogut l'estudiant, 0 en cas contrari.
+*
+* **********************************************/
+int moveStudent(Degrees *d, int degree_pos, char login[], int index){
+	int correct = 0;									// Variable que valdrà 1 si s'ha mogut l'estudiant.
+	int classroom_pos = 0;								// Variable on s'emmagatzemarà la posició de la classe origen.
+	ListNode student_node = NULL;						// Node de l'estudiant a la classe origen.
+	Degree *degree = &(d->elements[degree_pos]);		// Grau de l'estudiant.
+	Classroom *from, *to;								// Classe origen i classe destí.
+	Student student;									// Estudiant que es mou.
+
+	METRICS_START(TIMER_MOVE_STUDENT);
+
+	//Comprovo que existeix un estudiant amb el login introduit i que l'index compleix les condicions.
+	if(findLogin(login, d, &classroom_pos, &student_node, degree_pos)
+		&& index > 0 && index<=degree->num_classrooms && index-1 != classroom_pos && !isFull(&(degree->classrooms[index-1]))){
+		from = &(degree->classrooms[classroom_pos]);
+		to = &(degree->classrooms[index-1]);
+
+		// Agafo per escriure el lock de les dues classes, en ordre de posició com els lectors.
+		pthread_rwlock_wrlock(classroom_pos < index-1 ? &(from->lock) : &(to->lock));
+		pthread_rwlock_wrlock(classroom_pos < index-1 ? &(to->lock) : &(from->lock));
+
+		// Passo el node de l'estudiant a la nova classe, on li toca perquè la llista continuï ordenada.
+		student = spliceStudent(from, to, student_node);
+
+		// Les llistes ja compten el moviment, actualitzo la posició de les dues classes al heap.
+		heapUpdate(degree, index-1);
+		heapUpdate(degree, classroom_pos);
+		degreeChanged(d, degree_pos);
+		pthread_rwlock_unlock(&(to->lock));
+		pthread_rwlock_unlock(&(from->lock));
+
+		// El node no canvia, només cal actualitzar la classe a l'índex de logins.
+		indexLogin(d, student.login, degree_pos, index-1, student_node);
+		journalRecord(d, student.login, to->name);
+		correct = 1;
+	}
+	METRICS_STOP(TIMER_MOVE_STUDENT);
+	return(correct);
+}
+/*********************************************** 
+*
+* @Finalitat: Preguntar al usuari un grau, login del estudiant i index
+			  de la classe a la que és vol moure, i sempre que la informació 
+			  sigui correcte és mou a l'estudiant.
+* @Paràmetres: in: d = Punter a Degrees on es troba la direcció de tota la estructura creada previament.
+* @Retorn: ----
+*
+* **********************************************/
+void moveOption(Degrees *d){
+	char degree[MAX_STRING_LENGTH];						// Cadena on es guardarà el nom del grau.
+	int degree_pos = 0;									// Variable on s'emmagatzemarà la posició del grau a l'array dinàmica
+	int i = 0;											// Variable per al bucle for.
+	const Student *aux_student;							// Punter auxiliar per a llegir els estudiants de la llista sense copiar-los.
+	ListIterator iterator;								// Posició del recorregut de la llista.
+	char login[MAX_STRING_LENGTH];						// Cadena on es guardarà el login el estudiant.
+	int index = 0;										// Variable on es guardarà el index que introdueix l'usuari
+	int classroom_pos = 0;								// Variable on s'emmagatzemarà la posició de la classe origen.
+	ListNode student_node = NULL;						// Node de l'estudiant a la classe origen.
+	int error = 0;										// Variable flag per si alguna de les condicions no es compleix.
+
+	// Llegeixo el nom del grau que introdueix l'usuari sense \n.
+	printf("\nDegree? ");
+	fgets(degree, MAX_STRING_LENGTH, stdin);
+	degree[strlen(degree)-1] = '\0';
+
+	// Comprovo que el grau existeix amb la funció findDegree.
+	if(findDegree(d, degree, &degree_pos)){
+		printf("\n");
+		// Mostro quina és la distribució actual del grau.
+		printf("Classrooms and capacity:\n");
+		for(i=0;i<d->elements[degree_pos].num_classrooms;i++){
+			printf("%d. %s ",i+1, STRINGTABLE_get(d->strings, d->elements[degree_pos].classrooms[i].name));
+			printCapacity(&(d->elements[degree_pos].classrooms[i]));
+			printf("\n");
+			
+			// Recorro la llista amb LINKEDLIST_FOREACH_READ i printo el login de cada estudiant.
+			LINKEDLIST_FOREACH_READ(d->elements[degree_pos].classrooms[i].students, iterator, aux_student){
+				printf("%s\n", STRINGTABLE_get(d->strings, aux_student->login));
+			}
+		}
+		
+		//Llegeixo el nom del grau que introdueix l'usuari sense \n.
+		printf("\nWho do you want to move (login)? ");
+		scanf("%s", login);
+		
+		//Comprovo que existeix un estudiant amb el login introduit.
+		if(findLogin(login, d, &classroom_pos, &student_node, degree_pos)){
+
+			// Llegeixo l'index de la classe a la que s'ha de moure l'usuari.
+			printf("\nTo which classroom (index)? ");
+			scanf("%d", &index);
+
+			// Crido la funció moveStudent, que comprova l'index i mou l'estudiant.
+			error = !moveStudent(d, degree_pos, login, index);
+		}
+		else{
+			error = 1;
+		}
+	}
+	else{
+		error = 1;
+	}
+	// En cas de que les dades introduides no siguin correctes es mostra l'error.
+	if (error){
+		printf("\nERROR: Can't move student\n");
+
+	}
+}
+/*********************************************** 
+*
+* @Finalitat: Comparar dos moviments per grau i classe origen (per a qsort).
+
+* @Paràmetres: in: a = punter al primer moviment.
+			   in: b = punter al segon moviment.
+* @Retorn: Enter negatiu, zero o positiu si a va abans, igual o després de b.
+*
+* **********************************************/
+int compareMoves(const void *a, const void *b){
+	const BulkMove *ma = (const BulkMove *) a;
+	const BulkMove *mb = (const BulkMove *) b;
+	int result = 0;
+
+	if(ma->degree_pos != mb->degree_pos){
+		result = ma->degree_pos - mb->degree_pos;
+	}
+	else{
+		result = ma->classroom_pos - mb->classroom_pos;
+	}
+	return(result);
+}
+
+/*********************************************** 
+*
+* @Finalitat: Moure de cop tots els estudiants d'un fitxer de moviments. Cada línia té el login 
+			  de l'estudiant i el nom de la classe destí (del mateix grau). Primer es validen tots 
+			  els moviments en l'ordre del fitxer amb l'índex de logins, actualitzant les capacitats, 
+			  sense cap lock, i després s'apliquen tots agrupats per classe origen, passant cada node 
+			  a la posició que li toca a la classe destí. Mentre s'apliquen es té el lock de totes les 
+			  classes que toquen, així que cap lector veu el fitxer aplicat a mitges. Els moviments 
+			  incorrectes es mostren i no aturen la resta.
+
+* @Paràmetres: in/out: d = Punter a Degrees on es troba la direcció de tota la estructura creada previament.
+			   in: file_name = nom del fitxer de moviments.
+* @Retorn: Nombre de moviments que han fallat (-1 si no s'ha pogut obrir el fitxer).
+*
+* **********************************************/
+int bulkMove(Degrees *d, char file_name[]){
+	MappedFile f;									// Fitxer de moviments mapejat a memòria.
+	Parser p;										// Analitzador del contingut del fitxer.
+	const char *login, *classroom;					// Inici de cada camp dins del buffer.
+	int login_length = 0, classroom_length = 0;		// Longitud de cada camp.
+	int *move_to;									// Classe destí de cada estudiant (per localització) o -1.
+	BulkMove *moves;								// Estudiants que s'han de moure.
+	int num_moves = 0;								// Nombre d'estudiants que s'han de moure.
+	int failed = 0, moved = 0;						// Nombre de moviments que han fallat i d'estudiants moguts.
+	int line = 0;									// Línia del moviment, per als missatges d'error.
+	StringId id = 0;								// Identificador del login a la taula de noms.
+	int pos = 0;									// Posició de l'estudiant a l'array de localitzacions.
+	int from = 0, to = 0;							// Classe actual i classe destí de l'estudiant.
+	Degree *degree = NULL;							// Grau de l'estudiant.
+	char *involved;									// Classes que toquen els moviments (1) o no (0), grau a grau.
+	int *first;										// Posició de la primera classe de cada grau a involved.
+	int num_classrooms = 0;							// Nombre de classes de tots els graus.
+	int i = 0, n = 0, k = 0;						// Variables per als bucles.
+
+	f = MAPPEDFILE_open(file_name);
+	if(f == NULL){
+		printf("\nERROR: Can't open file '%s'\n", file_name);
+		return(-1);
+	}
+
+	move_to = (int *) malloc(sizeof(int)*(d->num_locations + 1));
+	moves = (BulkMove *) malloc(sizeof(BulkMove)*(d->num_locations + 1));
+	for(i=0;i<d->num_locations;i++){
+		move_to[i] = -1;
+	}
+	first = (int *) malloc(sizeof(int)*(d->num_degrees + 1));
+	for(i=0;i<d->num_degrees;i++){
+		first[i] = num_classrooms;
+		num_classrooms += d->elements[i].num_classrooms;
+	}
+	involved = (char *) calloc(num_classrooms + 1, sizeof(char));
+
+	// 1- Valido els moviments en l'ordre del fitxer. Els canvis de les classes es compten ara, 
+	//    perquè cada moviment vegi les classes tal com les han deixat els anteriors. Les llistes 
+	//    no canvien, així que no cal cap lock: els lectors només miren les llistes.
+	parserInit(&p, f, file_name);
+	while(!parserAtEnd(&p)){
+		line = p.line;
+		if(!parseWord(&p, &login, &login_length, "a login") || !parseField(&p, '\n', &classroom, &classroom_length, "a classroom name")
+			|| !parseEndOfLine(&p)){
+			// L'error de format ja s'ha mostrat, continuo amb la línia següent.
+			parserSkipLine(&p);
+			failed++;
+			continue;
+		}
+
+		pos = -1;
+		id = STRINGTABLE_findN(d->strings, login, login_length);
+		if(id != STRING_NOT_FOUND && id < d->max_location_of){
+			pos = d->location_of[id];
+		}
+		to = -1;
+		if(pos != -1){
+			degree = &(d->elements[d->locations[pos].degree_pos]);
+			from = (move_to[pos] != -1) ? move_to[pos] : d->locations[pos].classroom_pos;
+			to = findClassroom(d, d->locations[pos].degree_pos, classroom, classroom_length);
+		}
+
+		if(pos == -1 || to == -1 || to == from || isFull(&(degree->classrooms[to]))){
+			printf("\nERROR: Can't move student '%.*s' to '%.*s' (line %d)\n", login_length, login, classroom_length, classroom, line);
+			failed++;
+		}
+		else{
+			degree->classrooms[from].staged--;
+			degree->classrooms[to].staged++;
+			heapUpdate(degree, from);
+			heapUpdate(degree, to);
+			journalRecord(d, id, degree->classrooms[to].name);
+
+			// Si és el primer moviment de l'estudiant, el guardo per moure'l després.
+			if(move_to[pos] == -1){
+				moves[num_moves].degree_pos = d->locations[pos].degree_pos;
+				moves[num_moves].classroom_pos = d->locations[pos].classroom_pos;
+				moves[num_moves].location = pos;
+				num_moves++;
+			}
+			move_to[pos] = to;
+			moved++;
+		}
+	}
+	MAPPEDFILE_close(&f);
+
+	// 2- Marco totes les classes que toquen els moviments (les d'origen i les de destí) i n'agafo 
+	//    el lock per escriure per a tota la fase, grau a grau i en ordre de posició com la resta 
+	//    de fils: els lectors veuen les classes com estaven abans del fitxer o amb tots els 
+	//    moviments fets, mai a mitges.
+	for(i=0;i<num_moves;i++){
+		involved[first[moves[i].degree_pos] + moves[i].classroom_pos] = 1;
+		involved[first[moves[i].degree_pos] + move_to[moves[i].location]] = 1;
+	}
+	for(i=0;i<d->num_degrees;i++){
+		lockMarkedClassrooms(&(d->elements[i]), involved + first[i]);
+	}
+
+	// 3- Agrupo els moviments per classe origen i passo el node de cada estudiant a la posició 
+	//    que li toca a la classe destí: cada llista es toca un cop per grup i cap es torna a 
+	//    ordenar sencera.
+	qsort(moves, num_moves, sizeof(BulkMove), compareMoves);
+	i = 0;
+	while(i < num_moves){
+		degree = &(d->elements[moves[i].degree_pos]);
+		from = moves[i].classroom_pos;
+		n = 0;
+		while(i+n < num_moves && moves[i+n].degree_pos == moves[i].degree_pos && moves[i+n].classroom_pos == from){
+			n++;
+		}
+
+		for(k=i;k<i+n;k++){
+			pos = moves[k].location;
+			to = move_to[pos];
+			// Els estudiants que tornen a la seva classe no s'han de moure.
+			if(to != from){
+				spliceStudent(&(degree->classrooms[from]), &(degree->classrooms[to]), d->locations[pos].node);
+				d->locations[pos].classroom_pos = to;
+				degree->classrooms[from].staged++;
+				degree->classrooms[to].staged--;
+			}
+		}
+		degreeChanged(d, moves[i].degree_pos);
+		i += n;
+	}
+	for(i=0;i<d->num_degrees;i++){
+		unlockMarkedClassrooms(&(d->elements[i]), involved + first[i]);
+	}
+
+	printf("\nMoved %d students, %d failed\n", moved, failed);
+
+	free(move_to);
+	free(moves);
+	free(involved);
+	free(first);
+	return(failed);
+}
+/*********************************************** 
+*
+* @Finalitat: Preguntar al usuari el fitxer de moviments i moure'ls tots de cop.
+* @Paràmetres: in/out: d = Punter a Degrees on es troba la direcció de tota la estructura creada previament.
+* @Retorn: ----
+*
+* **********************************************/
+void bulkMoveOption(Degrees *d){
+	char file_name[MAX_STRING_LENGTH];					// Cadena on es guardarà el nom del fitxer.
+
+	printf("\nMoves file? ");
+	scanf("%s", file_name);
+	bulkMove(d, file_name);
+}
+/*********************************************** 
+*
+* @Finalitat: Actualitzar el hash FNV-1a d'un snapshot amb un bloc de bytes.
+* @Paràmetres: in: checksum = hash dels bytes anteriors.
+			   in: data = bytes a afegir al hash.
+			   in: bytes = nombre de bytes.
+* @Retorn: El hash actualitzat.
+*
+* **********************************************/
+unsigned int snapshotChecksum(unsigned int checksum, const void *data, long bytes){
+	const unsigned char *byte = (const unsigned char *) data;		// Byte que s'afegeix al hash.
+	long i = 0;														// Variable per al bucle for.
+
+	for(i=0;i<bytes;i++){
+		checksum ^= byte[i];
+		checksum *= 16777619u;
+	}
+	return(checksum);
+}
+/*********************************************** 
+*
+* @Finalitat: Escriure un bloc de bytes al snapshot i afegir-lo al hash i a la mida del contingut.
+* @Paràmetres: in: f = fitxer on s'escriu.
+			   in: data = bytes a escriure.
+			   in: bytes = nombre de bytes.
+			   in/out: header = capçalera on s'actualitzen el hash i la mida del contingut.
+* @Retorn: 1 si s'ha escrit tot el bloc, 0 en cas contrari.
+*
+* **********************************************/
+int snapshotWrite(FILE *f, const void *data, long bytes, SnapshotHeader *header){
+	header->checksum = snapshotChecksum(header->checksum, data, bytes);
+	header->payload_size += bytes;
+	return(bytes == 0 || fwrite(data, 1, bytes, f) == (size_t) bytes);
+}
+/*********************************************** 
+*
+* @Finalitat: Passar al disc (fsync) el directori on és un fitxer, perquè una operació sobre el 
+			  directori (com un rename) ja hi sigui si el sistema s'atura.
+* @Paràmetres: in: file_name = nom del fitxer (amb el camí, si no és al directori actual).
+* @Retorn: 1 si el directori és al disc, 0 en cas contrari.
+*
+* **********************************************/
+int syncDirectory(const char file_name[]){
+	char *dir_name = strdup(file_name);			// Camí del directori del fitxer.
+	char *slash = NULL;							// Última barra del camí.
+	int fd = -1;								// Descriptor del directori.
+	int correct = 0;							// Variable flag que determina si el directori és al disc.
+
+	if(dir_name == NULL){
+		return(0);
+	}
+	slash = strrchr(dir_name, '/');
+	if(slash == NULL){
+		strcpy(dir_name, ".");
+	}
+	else if(slash == dir_name){
+		dir_name[1] = '\0';
+	}
+	else{
+		*slash = '\0';
+	}
+	fd = open(dir_name, O_RDONLY);
+	if(fd != -1){
+		correct = fsync(fd) == 0;
+		close(fd);
+	}
+	free(dir_name);
+	return(correct);
+}
+/*********************************************** 
+*
+* @Finalitat: Obrir el fitxer temporal "<fitxer>.tmp" on s'escriu un fitxer abans de reanomenar-lo 
+			  amb la funció finishFile. El nom es reserva a mida del nom definitiu, sense cap límit, 
+			  perquè un nom tallat podria trepitjar un altre fitxer.
+
+* @Paràmetres: in: file_name = nom definitiu del fitxer.
+			   in: mode = mode d'obertura del fitxer (com fopen).
+			   out: tmp_name = Punter on es guarda el nom del fitxer temporal (l'allibera finishFile).
+* @Retorn: Fitxer temporal obert o NULL si no s'ha pogut obrir (es mostra l'error).
+*
+* **********************************************/
+FILE *openTemporary(const char file_name[], const char mode[], char **tmp_name){
+	FILE *f = NULL;								// Fitxer temporal.
+
+	*tmp_name = (char *) malloc(strlen(file_name) + sizeof(".tmp"));
+	if(*tmp_name == NULL){
+		printf("\nERROR: Can't open file '%s.tmp'\n", file_name);
+	}
+	else{
+		sprintf(*tmp_name, "%s.tmp", file_name);
+		f = fopen(*tmp_name, mode);
+		if(f == NULL){
+			printf("\nERROR: Can't open file '%s'\n", *tmp_name);
+			free(*tmp_name);
+			*tmp_name = NULL;
+		}
+	}
+	return(f);
+}
+/*********************************************** 
+*
+* @Finalitat: Acabar d'escriure un fitxer temporal obert amb la funció openTemporary, assegurar-se 
+			  que és al disc i reanomenar-lo amb el nom definitiu, de manera que el fitxer anterior 
+			  mai queda a mitges. Després es passa al disc el directori, perquè el nom nou no es 
+			  perdi si el sistema s'atura (el journal només es buida quan el fitxer compactat ja hi és).
+
+* @Paràmetres: in/out: f = fitxer temporal obert (es tanca sempre).
+			   in/out: tmp_name = nom del fitxer temporal (s'allibera sempre).
+			   in: file_name = nom definitiu del fitxer.
+			   in: correct = 1 si tot el contingut s'ha escrit correctament.
+* @Retorn: correct = 1 si el fitxer definitiu té el contingut nou, 0 en cas contrari.
+*
+* **********************************************/
+int finishFile(FILE *f, char *tmp_name, const char file_name[], int correct){
+	correct = correct && fflush(f) == 0 && fsync(fileno(f)) == 0;
+	correct = (fclose(f) == 0) && correct;
+	correct = correct && rename(tmp_name, file_name) == 0;
+	correct = correct && syncDirectory(file_name);
+
+	if(!correct){
+		remove(tmp_name);
+		printf("\nERROR: Can't write file '%s'\n", file_name);
+	}
+	free(tmp_name);
+	return(correct);
+}
+/*********************************************** 
+*
+* @Finalitat: Guardar tota l'estructura en un fitxer snapshot binari, que es pot carregar 
+			  en lloc dels fitxers de classes i d'estudiants. El fitxer s'escriu primer a 
+			  "<fitxer>.tmp" (openTemporary) i es reanomena amb la funció finishFile.
+
+* @Paràmetres: in: d = Punter a Degrees on es troba la direcció de tota la estructura creada previament.
+			   in: file_name = nom del fitxer snapshot.
+* @Retorn: correct = 1 si s'ha guardat el snapshot, 0 en cas contrari.
+*
+* **********************************************/
+int saveSnapshot(Degrees *d, const char file_name[]){
+	char *tmp_name;									// Nom del fitxer temporal.
+	FILE *f;										// Fitxer temporal.
+	SnapshotHeader header;							// Capçalera del snapshot.
+	SnapshotDegree degree;							// Registre d'un grau.
+	SnapshotClassroom classroom;					// Registre d'una classe.
+	const Student *student;							// Estudiant de la llista que s'està escrivint.
+	ListIterator iterator;							// Posició del recorregut de la llista.
+	const char *block;								// Bloc de textos de la taula de noms.
+	long bytes = 0;									// Bytes del bloc de textos.
+	int i = 0, j = 0;								// Variables per als bucles for.
+	int correct = 1;								// Variable flag que determina si s'ha escrit tot.
+
+	f = openTemporary(file_name, "wb", &tmp_name);
+	if(f == NULL){
+		return(0);
+	}
+	setvbuf(f, NULL, _IOFBF, OUTPUT_BUFFER);
+
+	// Escric la capçalera sense hash; es torna a escriure al final amb els valors bons.
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+	header.version = SNAPSHOT_VERSION;
+	header.checksum = 2166136261u;
+	header.num_degrees = d->num_degrees;
+	block = STRINGTABLE_block(d->strings, &bytes);
+	header.strings_bytes = bytes;
+	correct = fwrite(&header, sizeof(header), 1, f) == 1;
+
+	// Graus i classes.
+	for(i=0;i<d->num_degrees;i++){
+		degree.name = d->elements[i].name;
+		degree.num_classrooms = d->elements[i].num_classrooms;
+		correct = correct && snapshotWrite(f, &degree, sizeof(degree), &header);
+		header.num_classrooms += degree.num_classrooms;
+	}
+	for(i=0;i<d->num_degrees;i++){
+		for(j=0;j<d->elements[i].num_classrooms;j++){
+			classroom.name = d->elements[i].classrooms[j].name;
+			classroom.max_capacity = d->elements[i].classrooms[j].max_capacity;
+			classroom.num_students = LINKEDLIST_size(d->elements[i].classrooms[j].students);
+			correct = correct && snapshotWrite(f, &classroom, sizeof(classroom), &header);
+			header.num_students += classroom.num_students;
+		}
+	}
+	// Estudiants de cada classe, en l'ordre de la llista.
+	for(i=0;i<d->num_degrees && correct;i++){
+		for(j=0;j<d->elements[i].num_classrooms && correct;j++){
+			LINKEDLIST_FOREACH_READ(d->elements[i].classrooms[j].students, iterator, student){
+				correct = correct && snapshotWrite(f, student, sizeof(Student), &header);
+			}
+		}
+	}
+	// Textos de la taula de noms.
+	correct = correct && snapshotWrite(f, block, header.strings_bytes, &header);
+
+	// Torno a escriure la capçalera i m'asseguro que el fitxer és al disc abans de reanomenar-lo.
+	correct = correct && fseek(f, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, f) == 1;
+	correct = finishFile(f, tmp_name, file_name, correct);
+
+	if(correct){
+		printf("\nSaved %lld students to '%s'\n", header.num_students, file_name);
+	}
+	return(correct);
+}
+/*********************************************** 
+*
+* @Finalitat: Preguntar al usuari el nom del fitxer snapshot i guardar-hi tota l'estructura.
+* @Paràmetres: in: d = Punter a Degrees on es troba la direcció de tota la estructura creada previament.
+* @Retorn: ----
+*
+* **********************************************/
+void saveSnapshotOption(Degrees *d){
+	char file_name[MAX_STRING_LENGTH];					// Cadena on es guardarà el nom del fitxer.
+
+	printf("\nSnapshot file? ");
+	scanf("%s", file_name);
+	saveSnapshot(d, file_name);
+}
+/*********************************************** 
+*
+* @Finalitat: Comprovar si un fitxer mapejat és un snapshot (comença per SNAPSHOT_MAGIC).
+* @Paràmetres: in: f = fitxer mapejat a memòria.
+* @Retorn: 1 si el fitxer és un snapshot, 0 en cas contrari.
+*
+* **********************************************/
+int isSnapshot(MappedFile f){
+	return(MAPPEDFILE_size(f) >= (long) sizeof(SnapshotHeader) && memcmp(MAPPEDFILE_data(f), SNAPSHOT_MAGIC, 8) == 0);
+}
+/*********************************************** 
+*
+* @Finalitat: Mostrar un error de format d'un snapshot.
+* @Paràmetres: in: file_name = nom del fitxer.
+			   in: reason = descripció de l'error.
+* @Retorn: 0, per poder-lo retornar directament com a "correct".
+*
+* **********************************************/
+int snapshotError(const char file_name[], const char reason[]){
+	printf("\nERROR: Wrong snapshot '%s': %s\n", file_name, reason);
+	return(0);
+}
+/*********************************************** 
+*
+* @Finalitat: Llegir un snapshot i crear l'estructura a la memòria. Els textos es copien de 
+			  cop a la taula de noms (només es tornen a calcular els slots) i els estudiants 
+			  s'afegeixen a les llistes directament des del fitxer mapejat, en grups i amb 
+			  nodes del pool, sense tornar a analitzar cap text.
+
+* @Paràmetres: in: f = fitxer snapshot mapejat a memòria.
+			   in: file_name = nom del fitxer, per als missatges d'error.
+			   in/out: d = Punter a Punter a Degree que permet modificar el contingut de "d" fora del main.
+* @Retorn: correct = 1 si el snapshot és correcte, 0 si no (l'estructura es pot alliberar 
+		   amb la funció dealocation).
+*
+* **********************************************/
+int readSnapshot(MappedFile f, const char file_name[], Degrees **d){
+	const char *data = MAPPEDFILE_data(f);				// Contingut del fitxer.
+	SnapshotHeader header;								// Capçalera del snapshot.
+	const SnapshotDegree *degrees = NULL;				// Registres dels graus dins del fitxer.
+	const SnapshotClassroom *classrooms = NULL;			// Registres de les classes dins del fitxer.
+	const Student *students = NULL;						// Estudiants dins del fitxer.
+	const char *block = NULL;							// Bloc de textos dins del fitxer.
+	ListNode nodes[LOAD_BATCH];							// Nodes dels estudiants afegits en un grup.
+	Degree *degree;										// Punter auxiliar al grau que s'està creant.
+	Classroom *classroom;								// Punter auxiliar a la classe que s'està creant.
+	long long expected = 0;								// Mida que ha de tenir el contingut.
+	long long total = 0;								// Estudiants comptats a les classes.
+	int num_strings = 0;								// Nombre de textos de la taula de noms.
+	int i = 0, j = 0, k = 0, n = 0, c = 0;				// Variables per als bucles.
+	int correct = 1;									// Variable flag que determina si el snapshot és correcte.
+
+	// Deixo l'estructura buida, a punt per alliberar-la si el snapshot no és correcte.
+	(*d)->num_degrees = 0;
+	(*d)->elements = NULL;
+	(*d)->pool = LINKEDLIST_createPool();
+	(*d)->strings = NULL;
+	(*d)->degree_of = NULL;
+	(*d)->num_degree_of = 0;
+	(*d)->location_of = NULL;
+	(*d)->max_location_of = 0;
+	(*d)->locations = NULL;
+	(*d)->num_locations = 0;
+	(*d)->max_locations = 0;
+	(*d)->journal = NULL;
+	cacheInit(&((*d)->summary));
+	pthread_mutex_init(&((*d)->summary_lock), NULL);
+
+	// Comprovo la capçalera, les mides i el hash abans de fer servir cap dada.
+	memcpy(&header, data, sizeof(header));
+	if(header.version != SNAPSHOT_VERSION){
+		correct = snapshotError(file_name, "unsupported version");
+	}
+	else if(header.payload_size != MAPPEDFILE_size(f) - (long) sizeof(header) || header.num_degrees <= 0
+		|| header.num_classrooms <= 0 || header.num_students < 0 || header.strings_bytes < 0){
+		correct = snapshotError(file_name, "truncated file");
+	}
+	else{
+		expected = (long long) header.num_degrees*sizeof(SnapshotDegree) + (long long) header.num_classrooms*sizeof(SnapshotClassroom)
+			+ header.num_students*sizeof(Student) + header.strings_bytes;
+		if(expected != header.payload_size){
+			correct = snapshotError(file_name, "truncated file");
+		}
+		else if(snapshotChecksum(2166136261u, data + sizeof(header), header.payload_size) != header.checksum){
+			correct = snapshotError(file_name, "checksum mismatch");
+		}
+	}
+	if(correct){
+		degrees = (const SnapshotDegree *) (data + sizeof(header));
+		classrooms = (const SnapshotClassroom *) (degrees + header.num_degrees);
+		students = (const Student *) (classrooms + header.num_classrooms);
+		block = (const char *) (students + header.num_students);
+	}
+
+	// Creo la taula de noms a partir del bloc de textos.
+	(*d)->strings = correct ? STRINGTABLE_createFromBlock(block, header.strings_bytes) : STRINGTABLE_create(1);
+	if(correct && STRINGTABLE_getErrorCode((*d)->strings) != STRING_NO_ERROR){
+		correct = snapshotError(file_name, "wrong names block");
+	}
+	num_strings = STRINGTABLE_size((*d)->strings);
+
+	// Comprovo que tots els identificadors i els comptadors són coherents.
+	if(correct){
+		for(i=0;correct && i<header.num_degrees;i++){
+			correct = degrees[i].name >= 0 && degrees[i].name < num_strings && degrees[i].num_classrooms > 0 
+				&& degrees[i].num_classrooms <= header.num_classrooms - c;
+			c += correct ? degrees[i].num_classrooms : 0;
+		}
+		correct = correct && c == header.num_classrooms;
+		for(i=0;correct && i<header.num_classrooms;i++){
+			correct = classrooms[i].name >= 0 && classrooms[i].name < num_strings && classrooms[i].num_students >= 0
+				&& (classrooms[i].max_capacity == UNLIMITED || classrooms[i].max_capacity >= 0);
+			total += correct ? classrooms[i].num_students : 0;
+		}
+		correct = correct && total == header.num_students;
+		for(i=0;correct && i<header.num_students;i++){
+			correct = students[i].name >= 0 && students[i].name < num_strings && students[i].login >= 0 && students[i].login < num_strings;
+		}
+		if(!correct){
+			snapshotError(file_name, "inconsistent records");
+		}
+	}
+
+	if(correct){
+		// Reservo de cop els índexs de logins amb la mida final, no hauran de créixer.
+		(*d)->elements = (Degree *) malloc(sizeof(Degree)*header.num_degrees);
+		(*d)->max_location_of = num_strings;
+		(*d)->location_of = (int *) malloc(sizeof(int)*(num_strings > 0 ? num_strings : 1));
+		for(i=0;i<num_strings;i++){
+			(*d)->location_of[i] = -1;
+		}
+		(*d)->max_locations = (int) header.num_students;
+		(*d)->locations = (StudentLocation *) malloc(sizeof(StudentLocation)*(header.num_students > 0 ? header.num_students : 1));
+
+		// Creo els graus i les classes i hi afegeixo els estudiants en grups de LOAD_BATCH.
+		c = 0;
+		for(i=0;i<header.num_degrees;i++){
+			degree = &((*d)->elements[i]);
+			degree->name = degrees[i].name;
+			degree->num_classrooms = degrees[i].num_classrooms;
+			degree->classrooms = (Classroom *) malloc(sizeof(Classroom)*degree->num_classrooms);
+			degree->heap = (int *) malloc(sizeof(int)*degree->num_classrooms);
+			cacheInit(&(degree->summary));
+			cacheInit(&(degree->show));
+			pthread_mutex_init(&(degree->cache_lock), NULL);
+			memset(&(degree->waits), 0, sizeof(LockWaits));
+			(*d)->num_degrees++;
+
+			for(j=0;j<degree->num_classrooms;j++){
+				classroom = &(degree->classrooms[j]);
+				classroom->name = classrooms[c].name;
+				classroom->max_capacity = classrooms[c].max_capacity;
+				classroom->staged = 0;
+				classroom->students = LINKEDLIST_createWithPool((*d)->pool);
+				classroom->by_login = SKIPLIST_create(compareLogins, (*d)->strings);
+				pthread_rwlock_init(&(classroom->lock), NULL);
+				for(k=0;k<classrooms[c].num_students;k+=n){
+					n = classrooms[c].num_students - k < LOAD_BATCH ? classrooms[c].num_students - k : LOAD_BATCH;
+					addStudents(*d, students, n, i, j, nodes);
+					students += n;
+				}
+				c++;
+			}
+			buildHeap(degree);
+			// Les llistes ja estan ordenades, només se'n creen els índexs.
+			sortRosters(*d, i);
+		}
+		buildDegreeIndex(*d);
+	}
+	else{
+		(*d)->elements = (Degree *) malloc(sizeof(Degree));
+	}
+
+	return(correct);
+}
+/*********************************************** 
+*
+* @Finalitat: Guardar tots els estudiants en un fitxer amb el format del fitxer d'estudiants, 
+			  fixant cada estudiant a la classe on està ara ("login classe"), de manera que en 
+			  tornar-lo a llegir les classes queden igual. S'escriu amb la funció finishFile.
+
+* @Paràmetres: in: d = Punter a Degrees on es troba la direcció de tota la estructura creada previament.
+			   in: file_name = nom del fitxer d'estudiants.
+* @Retorn: correct = 1 si s'ha guardat el fitxer, 0 en cas contrari.
+*
+* **********************************************/
+int saveStudents(Degrees *d, const char file_name[]){
+	char *tmp_name;									// Nom del fitxer temporal.
+	FILE *f;										// Fitxer temporal.
+	const Student *student;							// Estudiant de la llista que s'està escrivint.
+	ListIterator iterator;							// Posició del recorregut de la llista.
+	const char *degree, *classroom;					// Nom del grau i de la classe que s'estan escrivint.
+	int i = 0, j = 0;								// Variables per als bucles for.
+	int correct = 1;								// Variable flag que determina si s'ha escrit tot.
+
+	f = openTemporary(file_name, "w", &tmp_name);
+	if(f == NULL){
+		return(0);
+	}
+	setvbuf(f, NULL, _IOFBF, OUTPUT_BUFFER);
+
+	for(i=0;i<d->num_degrees;i++){
+		degree = STRINGTABLE_get(d->strings, d->elements[i].name);
+		for(j=0;j<d->elements[i].num_classrooms;j++){
+			classroom = STRINGTABLE_get(d->strings, d->elements[i].classrooms[j].name);
+			LINKEDLIST_FOREACH_READ(d->elements[i].classrooms[j].students, iterator, student){
+				fprintf(f, "%s, %s\n%s %s\n", STRINGTABLE_get(d->strings, student->name), degree,
+					STRINGTABLE_get(d->strings, student->login), classroom);
+			}
+		}
+	}
+	correct = !ferror(f);
+	return(finishFile(f, tmp_name, file_name, correct));
+}
+/*********************************************** 
+*
+* @Finalitat: Escriure un camp CSV, entre cometes (i amb les cometes doblades) si té comes, 
+			  cometes o salts de línia.
+* @Paràmetres: in/out: f = fitxer on s'escriu.
+			   in: text = text del camp.
+* @Retorn: ----
+*
+* **********************************************/
+void writeCsvField(FILE *f, const char text[]){
+	const char *c;						// Caràcter que s'està escrivint.
+
+	if(strpbrk(text, ",\"\n\r") == NULL){
+		fputs(text, f);
+	}
+	else{
+		putc('"', f);
+		for(c=text;*c!='\0';c++){
+			if(*c == '"'){
+				putc('"', f);
+			}
+			putc(*c, f);
+		}
+		putc('"', f);
+	}
+}
+/*********************************************** 
+*
+* @Finalitat: Escriure un text com a cadena JSON, entre cometes i amb els caràcters especials escapats.
+* @Paràmetres: in/out: f = fitxer on s'escriu.
+			   in: text = text de la cadena.
+* @Retorn: ----
+*
+* **********************************************/
+void writeJsonString(FILE *f, const char text[]){
+	const unsigned char *c;				// Caràcter que s'està escrivint.
+
+	putc('"', f);
+	for(c=(const unsigned char *) text;*c!='\0';c++){
+		if(*c == '"' || *c == '\\'){
+			putc('\\', f);
+			putc(*c, f);
+		}
+		else if(*c < 0x20){
+			fprintf(f, "\\u%04x", *c);
+		}
+		else{
+			putc(*c, f);
+		}
+	}
+	putc('"', f);
+}
+/*********************************************** 
+*
+* @Finalitat: Exportar tota la distribució grau -> classe -> estudiant a un fitxer CSV o JSON 
+			  (si el nom acaba en ".json"). Els estudiants s'escriuen directament des de les 
+			  llistes, en una sola passada i a través d'un buffer de sortida gran, així que la 
+			  memòria no depèn del nombre d'estudiants. El CSV ("grau,classe,login,nom") es pot 
+			  tornar a carregar com a fitxer d'estudiants.
+
+* @Paràmetres: in: d = Punter a Degrees on es troba la direcció de tota la estructura creada previament.
+			   in: file_name = nom del fitxer on s'exporta.
+* @Retorn: correct = 1 si s'ha exportat la distribució, 0 en cas contrari.
+*
+* **********************************************/
+int exportDistribution(Degrees *d, const char file_name[]){
+	char *tmp_name;									// Nom del fitxer temporal.
+	FILE *f;										// Fitxer temporal.
+	Classroom *classroom;							// Classe que s'està exportant.
+	const Student *student;							// Estudiant de la llista que s'està exportant.
+	ListIterator iterator;							// Posició del recorregut de la llista.
+	const char *degree, *name;						// Nom del grau i de la classe que s'estan exportant.
+	size_t length = strlen(file_name);				// Longitud del nom del fitxer.
+	int json = length >= 5 && strcmp(file_name + length - 5, ".json") == 0;	// Variable flag del format.
+	int i = 0, j = 0;								// Variables per als bucles for.
+	long long num_students = 0;						// Estudiants exportats.
+	int first = 1;									// Variable flag per als separadors JSON.
+
+	f = openTemporary(file_name, "w", &tmp_name);
+	if(f == NULL){
+		return(0);
+	}
+	setvbuf(f, NULL, _IOFBF, OUTPUT_BUFFER);
+
+	if(json){
+		fputs("{\"degrees\":[", f);
+	}
+	else{
+		fprintf(f, "%s\n", CSV_HEADER);
+	}
+	for(i=0;i<d->num_degrees;i++){
+		degree = STRINGTABLE_get(d->strings, d->elements[i].name);
+		if(json){
+			fputs(i > 0 ? ",\n{\"name\":" : "\n{\"name\":", f);
+			writeJsonString(f, degree);
+			fputs(",\"classrooms\":[", f);
+		}
+		for(j=0;j<d->elements[i].num_classrooms;j++){
+			classroom = &(d->elements[i].classrooms[j]);
+			name = STRINGTABLE_get(d->strings, classroom->name);
+			if(json){
+				fputs(j > 0 ? ",\n {\"name\":" : "\n {\"name\":", f);
+				writeJsonString(f, name);
+				if(classroom->max_capacity == UNLIMITED){
+					fprintf(f, ",\"current_capacity\":%d,\"max_capacity\":null,\"students\":[", LINKEDLIST_size(classroom->students));
+				}
+				else{
+					fprintf(f, ",\"current_capacity\":%d,\"max_capacity\":%d,\"students\":[", LINKEDLIST_size(classroom->students), classroom->max_capacity);
+				}
+			}
+			first = 1;
+			LINKEDLIST_FOREACH_READ(classroom->students, iterator, student){
+				if(json){
+					fputs(first ? "\n  {\"login\":" : ",\n  {\"login\":", f);
+					writeJsonString(f, STRINGTABLE_get(d->strings, student->login));
+					fputs(",\"name\":", f);
+					writeJsonString(f, STRINGTABLE_get(d->strings, student->name));
+					putc('}', f);
+				}
+				else{
+					writeCsvField(f, degree);
+					putc(',', f);
+					writeCsvField(f, name);
+					putc(',', f);
+					writeCsvField(f, STRINGTABLE_get(d->strings, student->login));
+					putc(',', f);
+					writeCsvField(f, STRINGTABLE_get(d->strings, student->name));
+					putc('\n', f);
+				}
+				first = 0;
+				num_students++;
+			}
+			if(json){
+				fputs("]}", f);
+			}
+		}
+		if(json){
+			fputs("]}", f);
+		}
+	}
+	if(json){
+		fputs("\n]}\n", f);
+	}
+
+	if(finishFile(f, tmp_name, file_name, !ferror(f))){
+		printf("\nExported %lld students to '%s'\n", num_students, file_name);
+		return(1);
+	}
+	return(0);
+}
+/*********************************************** 
+*
+* @Finalitat: Preguntar al usuari el nom del fitxer i exportar-hi la distribució.
+* @Paràmetres: in: d = Punter a Degrees on es troba la direcció de tota la estructura creada previament.
+* @Retorn: ----
+*
+* **********************************************/
+void exportOption(Degrees *d){
+	char file_name[MAX_STRING_LENGTH];					// Cadena on es guardarà el nom del fitxer.
+
+	printf("\nExport file (.csv or .json)? ");
+	scanf("%s", file_name);
+	exportDistribution(d, file_name);
+}
+/*********************************************** 
+*
+* @Finalitat: Obrir el journal de moviments: si ja té moviments, es tornen a aplicar (amb la funció 
+			  bulkMove, ja que té el mateix format que un fitxer de moviments) sobre el que s'ha 
+			  carregat, i a partir d'ara s'hi afegeixen els moviments nous. Si l'últim moviment 
+			  està a mitges (el programa es va aturar mentre s'escrivia), es descarta.
+
+* @Paràmetres: in/out: d = Punter a Degrees on es troba la direcció de tota la estructura creada previament.
+			   in: file_name = nom del fitxer del journal (es crea si no existeix).
+			   in: target = fitxer d'estudiants (o snapshot) d'on s'han carregat els estudiants.
+			   in: snapshot = 1 si el fitxer target és un snapshot.
+* @Retorn: correct = 1 si s'ha obert el journal, 0 en cas contrari.
+*
+* **********************************************/
+int journalOpen(Degrees *d, const char file_name[], const char target[], int snapshot){
+	MappedFile f;									// Journal mapejat a memòria, per comprovar-lo.
+	const char *data;								// Contingut del journal.
+	long size = 0;									// Bytes del journal.
+	long i = 0;										// Variable per al bucle for.
+	int records = 0;								// Moviments que hi ha al journal.
+	Journal *journal;								// Journal que s'obre.
+
+	f = MAPPEDFILE_open(file_name);
+	if(f != NULL){
+		data = MAPPEDFILE_data(f);
+		size = MAPPEDFILE_size(f);
+		// Només compten els moviments acabats amb el salt de línia.
+		while(size > 0 && data[size-1] != '\n'){
+			size--;
+		}
+		for(i=0;i<size;i++){
+			if(data[i] == '\n'){
+				records++;
+			}
+		}
+		if(size != MAPPEDFILE_size(f)){
+			printf("\nWARNING: Dropped the incomplete last move of journal '%s'\n", file_name);
+		}
+		MAPPEDFILE_close(&f);
+		if(truncate(file_name, size) != 0){
+			printf("\nERROR: Can't write file '%s'\n", file_name);
+			return(0);
+		}
+		if(records > 0){
+			printf("\nReplaying journal '%s'\n", file_name);
+			bulkMove(d, (char *) file_name);
+		}
+	}
+
+	// Guardo els noms sencers (no es poden tallar: el journal es buidaria en un altre fitxer).
+	journal = (Journal *) malloc(sizeof(Journal));
+	journal->file_name = strdup(file_name);
+	journal->target = strdup(target);
+	journal->f = (journal->file_name != NULL && journal->target != NULL) ? fopen(file_name, "a") : NULL;
+	if(journal->f == NULL){
+		printf("\nERROR: Can't open file '%s'\n", file_name);
+		free(journal->file_name);
+		free(journal->target);
+		free(journal);
+		return(0);
+	}
+	journal->snapshot = snapshot;
+	journal->pending = 0;
+	journal->records = records;
+	d->journal = journal;
+	return(1);
+}
+/*********************************************** 
+*
+* @Finalitat: Passar al disc (fsync) els moviments del journal que encara no hi són.
+* @Paràmetres: in/out: journal = Punter al journal.
+* @Retorn: ----
+*
+* **********************************************/
+void journalSync(Journal *journal){
+	if(journal->pending > 0){
+		if(fflush(journal->f) != 0 || fsync(fileno(journal->f)) != 0){
+			printf("\nERROR: Can't write file '%s'\n", journal->file_name);
+		}
+		journal->pending = 0;
+	}
+}
+/*********************************************** 
+*
+* @Finalitat: Compactar el journal: guardar l'estat actual al fitxer d'estudiants (o al snapshot) 
+			  d'on es va carregar i buidar el journal, perquè no creixi sense límit. Si el programa 
+			  s'atura entre els dos passos, el journal es torna a aplicar sobre un fitxer que ja té 
+			  els moviments, i cada estudiant acaba igualment a la classe del seu últim moviment.
+
+* @Paràmetres: in/out: d = Punter a Degrees on es troba la direcció de tota la estructura creada previament.
+* @Retorn: correct = 1 si s'ha compactat el journal, 0 en cas contrari.
+*
+* **********************************************/
+int journalCompact(Degrees *d){
+	Journal *journal = d->journal;					// Journal que es compacta.
+	int correct = 0;								// Variable flag que determina si s'ha compactat.
+
+	if(journal == NULL){
+		printf("\nERROR: There is no journal\n");
+	}
+	else{
+		journalSync(journal);
+		correct = journal->snapshot ? saveSnapshot(d, journal->target) : saveStudents(d, journal->target);
+		if(correct){
+			fclose(journal->f);
+			journal->f = fopen(journal->file_name, "w");
+			correct = journal->f != NULL && fsync(fileno(journal->f)) == 0;
+			if(correct){
+				journal->records = 0;
+				printf("\nCompacted journal into '%s'\n", journal->target);
+			}
+			else{
+				printf("\nERROR: Can't write file '%s'\n", journal->file_name);
+			}
 		}
-		i++;
 	}
+	return(correct);
 }
-
 /*********************************************** 
 *
-* @Finalitat: Cerca la posició en la que es troba el grau que introdueix l'usuari
-			  i a part també retorna de forma indirecta quina és la primera classe 
-			  sense omplir i quina posició és la que ha d'ocupar l'estudiant.
-
-* @Paràmetres: in: degree = cadena on està el nom del grau.
-			   in: d = Punter a Degrees on està emmagatzemada tota la informació.
-			   in/out: pos_classroom = Punter a enter on s'emmagatzema la direcció
-			   	   de la posició de la classe que ha d'ocupar l'estudiant.
-			   in/out: current_pos = Punter a enter on s'emmagatzema la direcció
-			   	   de la posició que ha d'ocupar l'estudiant dintre la classe.
+* @Finalitat: Acabar una operació: si el journal ja té un lot de moviments (o si es demana), 
+			  passar-los al disc, i si té massa moviments, compactar-lo.
 
-* @Retorn: pos_degree = posició de l'array dinàmica on es troba el grau del estudiant.
+* @Paràmetres: in/out: d = Punter a Degrees on es troba la direcció de tota la estructura creada previament.
+			   in: force = 1 per passar al disc els moviments encara que no facin un lot sencer.
+* @Retorn: ----
 *
 * **********************************************/
-int searchPosition(char degree[], Degrees **d, int *current_pos){
-	int i = 0;							// Variable per al bucle for.
-	int pos_degree = 0;					// Posició de l'array dinàmica on està el grau introduit.
-	int continua = 1;					// Variavle flag per al bucle while.
-
-	// Faig un bucle for per trobar la posició del grau a l'array dinàmica.
-	for(i=0;i<(*d)->num_degrees;i++){
-		if(strcmp(degree, (*d)->elements[i].name) == 0){
-			pos_degree = i;
+void journalCommit(Degrees *d, int force){
+	if(d->journal != NULL && d->journal->f != NULL){
+		if(force || d->journal->pending >= JOURNAL_SYNC_BATCH){
+			journalSync(d->journal);
+		}
+		if(d->journal->records >= JOURNAL_COMPACT_RECORDS){
+			journalCompact(d);
 		}
 	}
-	// Resetejo la i.
-	
-
-
-
-	return(pos_degree);
 }
-
 /*********************************************** 
 *
-* @Finalitat: Llegir el segon fitxer amb els estudiants i emmagatzemar-lo a la memòria de forma ordenada.
-
-* @Paràmetres: in: f2 = punter a FILE que conté la direcció del fitxer obert.
-			   in/out: d = punter a Punter a Degree que permet modificar el contingut de "d" fora del main.
+* @Finalitat: Passar al disc els últims moviments i tancar el journal.
+* @Paràmetres: in/out: d = Punter a Degrees on es troba la direcció de tota la estructura creada previament.
 * @Retorn: ----
 *
 * **********************************************/
-void readFileTwo(FILE *f2, Degrees **d){
-    char degree[MAX_STRING_LENGTH];
-	char trash;										// Variable per netejar el buffer.
-	// int class_position = 0;							// Variable que es farà servir per emmagatzemar el estudiant a la classe disponible.
-	int pos_degree = 0;								// Variable on es guardrà la posició del grau.
-	int current_pos = 0;							// Variable que es farà servir per emmagatzemar el estudiant a la possició disponible.
-	Student aux_student;							// Variable auxiliar per a llegir els estudiants de la llista
-
-	// Llegeixo la informació de fitxer eliminant els \n.
-	fscanf(f2, "%s", aux_student.name);
-	aux_student.name[strlen(aux_student.name)-1] = '\0';
-	fscanf(f2, "%c", &trash);
-	fgets(degree, MAX_STRING_LENGTH, f2);
-	degree[strlen(degree)-1] = '\0';
-	fscanf(f2, "%s", aux_student.login);
-	
-	// Crido a la funció search position per trobar la posició del grau, la classe disponible i la posició on es guardarà l'estudiant. 
-	pos_degree = searchPosition(degree, d, &current_pos);
-
-	// Afegeixo a la lliste el estudiant llegit del arxiu.
-    (*d)->elements[pos_degree].classrooms[0].current_capacity++;
-	LINKEDLIST_add((*d)->elements[pos_degree].classrooms[0].students, aux_student);
-	
-	// Creo un bucle while per llegir el fitxer fins que aquest acabi.
-	while(!feof(f2)){
-	
-	// Llegeixo la informació de fitxer eliminant els \n.
-	fscanf(f2, "%s", aux_student.name);
-	aux_student.name[strlen(aux_student.name)-1] = '\0';
-	fscanf(f2, "%c", &trash);
-	fgets(degree,MAX_STRING_LENGTH, f2);
-	degree[strlen(degree)-1] = '\0';
-	fscanf(f2, "%s", aux_student.login);
-
-	// Crido a la funció search position per trobar la posició del grau, la classe disponible i la posició on es guardarà l'estudiant. 
-	pos_degree = searchPosition(degree, d, &current_pos);
-
-	// Afegeixo a la lliste el estudiant llegit del arxiu.
-    (*d)->elements[pos_degree].classrooms[0].current_capacity++;
-	LINKEDLIST_add((*d)->elements[pos_degree].classrooms[0].students, aux_student);
+void journalClose(Degrees *d){
+	if(d->journal != NULL){
+		if(d->journal->f != NULL){
+			journalSync(d->journal);
+			fclose(d->journal->f);
+		}
+		free(d->journal->file_name);
+		free(d->journal->target);
+		free(d->journal);
+		d->journal = NULL;
 	}
 }
-
 /*********************************************** 
 *
-* @Finalitat: Mostrar les dades llegides anteriorment de forma ordenada per graus.
-* @Paràmetres: in: d = Punter a degrees on es troba la direcció de tota la estructura creada previament.
-* @Retorn: ----
+* @Finalitat: Obtenir un nombre aleatori (xorshift), amb un estat propi per a cada fil.
+* @Paràmetres: in/out: seed = Punter a l'estat dels nombres aleatoris.
+* @Retorn: Nombre aleatori.
 *
 * **********************************************/
-void summaryOption(Degrees *d){
-	int j = 0, k = 0;					// Variables per als bucles for.
+unsigned int stressRandom(unsigned int *seed){
+	*seed ^= *seed << 13;
+	*seed ^= *seed >> 17;
+	*seed ^= *seed << 5;
+	return(*seed);
+}
 
-	// Faig dos bucles for per printar tota la informació del grau.
-	for(j=0;j<d->num_degrees;j++){
-		printf("\n%s\n", d->elements[j].name);
+/*********************************************** 
+*
+* @Finalitat: Comprovar els estudiants ja preparats d'un grau: hi ha d'haver tots els estudiants 
+			  del grau, i cadascun un sol cop.
 
-		for(k = 0;k<d->elements[j].num_classrooms;k++){
-			printf("%s %d/inf\n", d->elements[j].classrooms[k].name,d->elements[j].classrooms[k].current_capacity);
+* @Paràmetres: in/out: r = Punter a les dades del lector.
+			   in: show = Punter als estudiants del grau ja preparats.
+			   in: total = nombre d'estudiants del grau.
+* @Retorn: 1 si els estudiants quadren, 0 en cas contrari.
+*
+* **********************************************/
+int stressCheckShow(StressReader *r, const OutputCache *show, int total){
+	const char *line, *end, *login;		// Inici i final de la línia i inici del login.
+	const char *text_end = show->text + show->length;
+	int lines = 0;						// Línies d'estudiants.
+	int correct = 1;					// Variable que valdrà 0 si algun estudiant no quadra.
+	StringId id = 0;					// Identificador del login a la taula de noms.
+
+	// Cada línia és "nom (login): classe". La primera línia és buida.
+	r->stamp++;
+	line = show->text + 1;
+	while(correct && line < text_end){
+		end = memchr(line, '\n', text_end - line);
+		login = end;
+		while(login > line && !(login[0] == ')' && login[1] == ':')){
+			login--;
+		}
+		end = login;
+		while(login > line && login[-1] != '('){
+			login--;
+		}
+		id = STRINGTABLE_lookupN(r->d->strings, login, (int) (end - login));
+		if(id == STRING_NOT_FOUND || r->seen[id] == r->stamp){
+			correct = 0;
 		}
+		else{
+			r->seen[id] = r->stamp;
+		}
+		line = (const char *) memchr(end, '\n', text_end - end) + 1;
+		lines++;
 	}
+	return(correct && lines == total);
 }
 
 /*********************************************** 
 *
-* @Finalitat: Comprovar si el grau introduit per l'usuari està a la memòria i axtualitzar la seva posició.
-
-* @Paràmetres: in: d = Punter a degrees on es troba la direcció de tota la estructura creada previament.
-			   in: degree = cadena on està el nom del grau.
-			   in/out: degree_pos = Punter a enter on s'emmagatzema la direcció de la variable 
-			       que determina la posició on es situa el grau introduit per l'usuari.
+* @Finalitat: Comprovar el resum ja preparat d'un grau: la suma dels estudiants de les classes 
+			  ha de ser el nombre d'estudiants del grau.
 
-* @Retorn: correct = variable de tipus enter que valdrà 1 o 0 depenent si el grau introduit existeix a la memòria.
+* @Paràmetres: in: summary = Punter al resum del grau ja preparat.
+			   in: total = nombre d'estudiants del grau.
+* @Retorn: 1 si el resum quadra, 0 en cas contrari.
 *
 * **********************************************/
-int findDegree(Degrees *d, char degree[], int *degree_pos){
-	int i = 0;					// Variable per al bucle for.
-	int correct = 0;			// Variable que valdrà 1 o 0 depenent si el grau introduit existeix a la memòria.
-	
-	// Faig un bucle for per comprovar que existeix el grau a la memòria i trobar la seva posició.
-	for(i=0;i<d->num_degrees;i++){
-		if(strcmp(degree, d->elements[i].name) == 0){
-			correct = 1;
-			*degree_pos = i;
+int stressCheckSummary(const OutputCache *summary, int total){
+	const char *line, *end, *count;		// Inici i final de la línia i inici del nombre d'estudiants.
+	const char *text_end = summary->text + summary->length;
+	int sum = 0;						// Suma dels estudiants de les classes.
+
+	// La primera línia és buida i la segona és el nom del grau. Cada classe és "nom n/capacitat".
+	line = (const char *) memchr(summary->text + 1, '\n', summary->length - 1) + 1;
+	while(line < text_end){
+		end = memchr(line, '\n', text_end - line);
+		count = end;
+		while(count > line && count[-1] != ' '){
+			count--;
 		}
+		sum += atoi(count);
+		line = end + 1;
 	}
-	return(correct);
+	return(sum == total);
 }
+
 /*********************************************** 
 *
-* @Finalitat: Preguntar al usuari quin grau vol veure la seva informació 
-			  i seguidament mostrar-la en cas que aquest existeixi.
+* @Finalitat: Llegir graus a l'atzar (estudiants, resum del grau i, de tant en tant, el resum de 
+			  tots els graus) fins que s'acabin els moviments, comprovant que cada lectura quadra.
 
-* @Paràmetres: in: d = Punter a degrees on es troba la direcció de tota la estructura creada previament.
-* @Retorn: ----
+* @Paràmetres: in/out: arg = Punter a StressReader amb les dades del lector.
+* @Retorn: NULL.
 *
 * **********************************************/
-void showOption(Degrees *d){
-	char degree[MAX_STRING_LENGTH];				// Cadena on es guardarà el nom del grau.
-	int degree_pos = 0;							// Variable on es guardarà la posició del grau.
-	int i = 0, j = 0;							// Variables per als bucles for.
-    Student aux_student;						// Variable auxiliar per a llegir els estudiants de la llista
-
-	// Obtinc el nom del grau sense \n.
-	printf("\nDegree to show? ");
-	fgets(degree, MAX_STRING_LENGTH-1, stdin);
-	degree[strlen(degree)-1] = '\0';
-	
-	//Comprovo si existeix el grau amb la funció findDegree.
-	if(findDegree(d, degree, &degree_pos)){
-		printf("\n");
+void *stressReader(void *arg){
+	StressReader *r = (StressReader *) arg;
+	Degrees *d = r->d;
+	int degree_pos = 0;					// Grau que es llegeix.
+	int last = 0;						// Variable flag que val 1 a l'última lectura.
+
+	// Després de l'últim moviment encara es fa una lectura, que veu l'estat final.
+	while(!last){
+		last = __atomic_load_n(r->done, __ATOMIC_SEQ_CST);
+		degree_pos = stressRandom(&(r->seed)) % d->num_degrees;
+
+		pthread_mutex_lock(&(d->elements[degree_pos].cache_lock));
+		if(!stressCheckShow(r, renderDegreeShow(d, degree_pos), r->totals[degree_pos])){
+			r->inconsistent++;
+		}
+		if(!stressCheckSummary(renderDegreeSummary(d, degree_pos), r->totals[degree_pos])){
+			r->inconsistent++;
+		}
+		pthread_mutex_unlock(&(d->elements[degree_pos].cache_lock));
 
-		for(i=0;i<d->elements[degree_pos].num_classrooms;i++){
-			// Vaig al principi de la llista amb la funció LINKEDLIST_goToHead.
-            LINKEDLIST_goToHead(d->elements[degree_pos].classrooms[i].students);
-
-            for(j=0;j<d->elements[degree_pos].classrooms[i].current_capacity;j++){
-			// Extrec el estudiant i l'asigno a la variable auxiliar.
-            aux_student = LINKEDLIST_get(d->elements[degree_pos].classrooms[i].students);
-            
-            printf("%s (%s): %s\n", aux_student.name, aux_student.login, d->elements[degree_pos].classrooms[i].name);
-            
-			// Avanço el POV de la llista per poder seguir llegint els estudiants d'aquesta.
-            LINKEDLIST_next(d->elements[degree_pos].classrooms[i].students);
-            }
-			
+		if(r->reads % 16 == 0){
+			pthread_mutex_lock(&(d->summary_lock));
+			renderSummary(d);
+			pthread_mutex_unlock(&(d->summary_lock));
 		}
+		r->reads++;
 	}
-	else{
-		printf("\nERROR: Can't find degree\n");
-	}
+	return(NULL);
 }
+
 /*********************************************** 
 *
-* @Finalitat: Comprova que hi ha algu estudiant amb el login introduit i actualitza
-			  les variables de la seva posició a la classe i la possició de la classe.
-
-* @Paràmetres: in: login = cadena on està el login a cercar.
-			   in: d = Punter a Degrees on es troba la direcció de tota la estructura creada previament.
-			   in/out: classroom_pos = Punter a enter on s'emmagatzema la direcció de la variable 
-			       que determina la posició on es situa la classe del estudiant.
-			   in/out: student_pos = Punter a enter on s'emmagatzema la direcció de la variable 
-			       que determina la posició on es situa l'estudiant dintre la classe.	
-			   in: degree_pos = posició de l'array dinàmica on està el grau on es vol cercar el login.
-
-* @Retorn: Retorna una variable de tipus int que val 1 o 0 depenent si s'ha trobat un estudiant amb el login introduït o no.
+* @Finalitat: Comprovar l'accés concurrent: mentre uns quants fils llegeixen graus a l'atzar, 
+			  aquest fil mou estudiants a l'atzar a una altra classe del seu grau. Els moviments 
+			  són de debò (també van al journal). Cada lectura ha de veure tots els estudiants 
+			  del grau un sol cop, sense cap moviment a mitges. Al final es mostra quantes vegades 
+			  i quant de temps els lectors han esperat un moviment (LockWaits).
+
+* @Paràmetres: in/out: d = Punter a Degrees on està emmagatzemada tota la informació.
+			   in: num_readers = nombre de fils lectors.
+			   in: num_moves = nombre de moviments.
+* @Retorn: 1 si totes les lectures quadren, 0 en cas contrari.
 *
 * **********************************************/
-int findLogin(char login[], Degrees *d, int *classroom_pos, int *student_pos, int degree_pos){
-	int i = 0, j = 0;				// Variables per als bucles for.
-	int correct = 0;				// Variable que valdrà 1 o 0 depenent si el login és correcte.
-    Student aux_student;
-
-	// Faig dos bucles for per comrovar si existeix el login.  
-	for(i = 0; i < d->elements[degree_pos].num_classrooms; i++){
-		// Vaig al principi de la llista amb la funció LINKEDLIST_goToHead.
-        LINKEDLIST_goToHead(d->elements[degree_pos].classrooms[i].students);
-		for(j = 0; j < d->elements[degree_pos].classrooms[i].current_capacity; j++){
-			// Extrec el estudiant i l'asigno a la variable auxiliar.
-            aux_student = LINKEDLIST_get(d->elements[degree_pos].classrooms[i].students);
-			if(strcmp(login, aux_student.login) == 0){
-				// Actulitzo la posició de la seva classe desreferenciant el punter.
-				*classroom_pos = i;
-				// Actualitzo la posició dintre de la classe desreferenciant el punter.
-				*student_pos = j;
+int stressTest(Degrees *d, int num_readers, int num_moves){
+	StressReader *readers;								// Dades de cada lector.
+	pthread_t *threads;									// Fils lectors.
+	int *totals;										// Estudiants de cada grau.
+	StressStudent *students;							// Tots els estudiants, per escollir-los a l'atzar.
+	int num_students = 0;
+	int done = 0;										// Variable flag que val 1 quan s'acaben els moviments.
+	char login[SCRIPT_LINE_LENGTH];						// Login de l'estudiant que es mou.
+	unsigned int seed = 2463534242u;					// Estat dels nombres aleatoris dels moviments.
+	int i = 0, j = 0, moved = 0;						// Variables per als bucles i moviments fets.
+	long long reads = 0, inconsistent = 0;				// Lectures fetes i lectures que no quadren.
+	LockWaits waits = {0, 0, 0};						// Esperes dels lectors als moviments.
+	ListIterator iterator;								// Posició del recorregut de les llistes.
+	const Student *aux_student;							// Estudiant de la llista.
+
+	if(num_readers < 1 || num_readers > MAX_THREADS || d->num_degrees == 0 || d->num_locations == 0){
+		printf("\nERROR: Can't run the stress test\n");
+		return(0);
+	}
 
-				correct = 1;
+	// Encara no hi ha cap lector: compto els estudiants de cada grau i els apunto tots.
+	totals = (int *) malloc(sizeof(int)*d->num_degrees);
+	students = (StressStudent *) malloc(sizeof(StressStudent)*d->num_locations);
+	for(i=0;i<d->num_degrees;i++){
+		totals[i] = 0;
+		memset(&(d->elements[i].waits), 0, sizeof(LockWaits));
+		for(j=0;j<d->elements[i].num_classrooms;j++){
+			totals[i] += LINKEDLIST_size(d->elements[i].classrooms[j].students);
+			LINKEDLIST_FOREACH_READ(d->elements[i].classrooms[j].students, iterator, aux_student){
+				students[num_students].login = aux_student->login;
+				students[num_students].degree_pos = i;
+				num_students++;
 			}
-			// Avanço el POV de la llista per poder seguir llegint els estudiants d'aquesta.
-            LINKEDLIST_next(d->elements[degree_pos].classrooms[i].students);
 		}
 	}
-	return(correct);
+
+	readers = (StressReader *) malloc(sizeof(StressReader)*num_readers);
+	threads = (pthread_t *) malloc(sizeof(pthread_t)*num_readers);
+	for(i=0;i<num_readers;i++){
+		readers[i].d = d;
+		readers[i].totals = totals;
+		readers[i].done = &done;
+		readers[i].seen = (int *) calloc(STRINGTABLE_size(d->strings) + 1, sizeof(int));
+		readers[i].stamp = 0;
+		readers[i].seed = 2463534242u + i + 1;
+		readers[i].reads = 0;
+		readers[i].inconsistent = 0;
+		pthread_create(&(threads[i]), NULL, stressReader, &(readers[i]));
+	}
+
+	for(i=0;i<num_moves;i++){
+		j = stressRandom(&seed) % num_students;
+		snprintf(login, SCRIPT_LINE_LENGTH, "%s", STRINGTABLE_get(d->strings, students[j].login));
+		moved += moveStudent(d, students[j].degree_pos, login,
+			1 + stressRandom(&seed) % d->elements[students[j].degree_pos].num_classrooms);
+	}
+	__atomic_store_n(&done, 1, __ATOMIC_SEQ_CST);
+
+	for(i=0;i<num_readers;i++){
+		pthread_join(threads[i], NULL);
+		reads += readers[i].reads;
+		inconsistent += readers[i].inconsistent;
+		free(readers[i].seen);
+	}
+	printf("\nStress: %d readers, %lld reads, %d moves, %lld inconsistent\n", num_readers, reads, moved, inconsistent);
+
+	// Els lectors es bloquegen mentre un moviment té les classes del grau: mostro quant.
+	for(i=0;i<d->num_degrees;i++){
+		waits.count += d->elements[i].waits.count;
+		waits.total_ns += d->elements[i].waits.total_ns;
+		waits.max_ns = (d->elements[i].waits.max_ns > waits.max_ns) ? d->elements[i].waits.max_ns : waits.max_ns;
+	}
+	printf("Readers blocked by a move: %lld times, %.3f ms in total, %.3f ms the longest\n", waits.count, 
+		waits.total_ns/1e6, waits.max_ns/1e6);
+
+	free(readers);
+	free(threads);
+	free(totals);
+	free(students);
+	return(inconsistent == 0);
 }
+
 /*********************************************** 
 *
-* @Finalitat: Preguntar al usuari un grau, login del estudiant i index
-			  de la classe a la que és vol moure, i sempre que la informació 
-			  sigui correcte és mou a l'estudiant.
-* @Paràmetres: in: d = Punter a Degrees on es troba la direcció de tota la estructura creada previament.
-* @Retorn: ----
+* @Finalitat: Executar les comandes d'un fitxer (o de l'entrada estàndard) una darrera l'altra, 
+			  sense preguntar res a l'usuari. Cada línia és una comanda:
+			      summary
+			      show <grau>
+			      move <login> <index> <grau>
+			      bulkmove <fitxer de moviments>
+			      save <fitxer snapshot>
+			      compact
+			      export <fitxer .csv o .json>
+			      exit
+			  Les línies buides i les que comencen per '#' s'ignoren.
+
+* @Paràmetres: in/out: d = Punter a Degrees on es troba la direcció de tota la estructura creada previament.
+			   in: script = fitxer obert d'on es llegeixen les comandes.
+* @Retorn: Nombre de comandes que han fallat.
 *
 * **********************************************/
-void moveOption(Degrees *d){
-	char degree[MAX_STRING_LENGTH];						// Cadena on es guardarà el nom del grau.
-	int degree_pos = 0;									// Variable on s'emmagatzemarà la posició del grau a l'array dinàmica
-	int i = 0, j = 0;									// Variables for per als bucles while.
-	char login[MAX_STRING_LENGTH];						// Cadena on es guardarà el login el estudiant.
-	int index = 0;										// Variable on es guardarà el index que introdueix l'usuari
-	int classroom_pos = 0, student_pos_copy = 0;		// Variables on s'emmagatzemarà la posició destí i origen de la classe respectivament.
-	int error = 0;										// Variable flag per si alguna de les condicions no es compleix.
-	int student_position = 0;							// Posició on s'haura de traspassar el usuari.
-    Student student_copy;
-
-	// Llegeixo el nom del grau que introdueix l'usuari sense \n.
-	printf("\nDegree? ");
-	fgets(degree, MAX_STRING_LENGTH, stdin);
-	degree[strlen(degree)-1] = '\0';
-
-	// Comprovo que el grau existeix amb la funció findDegree.
-	if(findDegree(d, degree, &degree_pos)){
-		printf("\n");
-		// Mostro quina és la distribució actual del grau.
-		printf("Classrooms and capacity:\n");
-		for(i=0;i<d->elements[degree_pos].num_classrooms;i++){
-			printf("%d. %s %d/inf\n",i+1, d->elements[degree_pos].classrooms[i].name, d->elements[degree_pos].classrooms[i].current_capacity);
-			
-			// Vaig al principi de la llista amb la funció LINKEDLIST_goToHead.
-            LINKEDLIST_goToHead(d->elements[degree_pos].classrooms[i].students);
-
-			for(j=0;j<d->elements[degree_pos].classrooms[i].current_capacity;j++){
-
-				// Extrec el estudiant i el printo
-				printf("%s\n", (LINKEDLIST_get(d->elements[degree_pos].classrooms[i].students)).login);
+int runScript(Degrees *d, FILE *script){
+	char line[SCRIPT_LINE_LENGTH];						// Línia del fitxer de comandes.
+	char login[SCRIPT_LINE_LENGTH];						// Cadena on es guardarà el login de la comanda move.
+	char *command, *args;								// Inici de la comanda i dels seus arguments dins de la línia.
+	int index = 0;										// Índex de la classe de la comanda move.
+	int consumed = 0;									// Caràcters dels arguments llegits amb sscanf.
+	int readers = 0, moves = 0;							// Fils lectors i moviments de la comanda stress.
+	int degree_pos = 0;									// Posició del grau de la comanda move.
+	int num_line = 0;									// Número de la línia actual.
+	int failed = 0;										// Nombre de comandes que han fallat.
+	int continua = 1;									// Variable flag per al bucle while.
+	int length = 0;										// Longitud de la línia.
+
+	while(continua && fgets(line, SCRIPT_LINE_LENGTH, script) != NULL){
+		num_line++;
+
+		// Elimino el salt de línia (i el \r) i els espais del principi.
+		length = strlen(line);
+		while(length > 0 && (line[length-1] == '\n' || line[length-1] == '\r' || line[length-1] == ' ')){
+			length--;
+		}
+		line[length] = '\0';
+		command = line;
+		while(*command == ' ' || *command == '\t'){
+			command++;
+		}
 
-				// Avanço el POV de la llista per poder seguir llegint els estudiants d'aquesta.
-                LINKEDLIST_next(d->elements[degree_pos].classrooms[i].students);
+		// Separo la comanda dels arguments.
+		args = command;
+		while(*args != '\0' && *args != ' '){
+			args++;
+		}
+		if(*args != '\0'){
+			*args = '\0';
+			args++;
+			while(*args == ' '){
+				args++;
 			}
 		}
-		
-		//Llegeixo el nom del grau que introdueix l'usuari sense \n.
-		printf("\nWho do you want to move (login)? ");
-		scanf("%s", login);
-		
-		//Comprovo que existeix un estudiant amb el login introduit.
-		if(findLogin(login, d, &classroom_pos, &student_pos_copy, degree_pos)){
-
-			// Llegeixo l'index de la classe a la que s'ha de moure l'usuari.
-			printf("\nTo which classroom (index)? ");
-			scanf("%d", &index);
 
-			// Comprovo que aquest compleix les condicions.
-			if(index > 0 && index<=d->elements[degree_pos].num_classrooms && index-1 != classroom_pos){
-				
-				// Vaig al principi de la llista amb la funció LINKEDLIST_goToHead.
-                LINKEDLIST_goToHead(d->elements[degree_pos].classrooms[classroom_pos].students);
-                for(i=0;i<student_pos_copy;i++){
-
-					// Avanço el POV de la llista per trobar la posicio del estudiant a copiar.
-                    LINKEDLIST_next(d->elements[degree_pos].classrooms[classroom_pos].students);
-                }
-				// Extrec el estudiant i l'asigno a la variable auxiliar.
-                student_copy = LINKEDLIST_get(d->elements[degree_pos].classrooms[classroom_pos].students);
-                
-                
-                // Afegeixo l'estudiant a la nova posició de la llista
-				LINKEDLIST_add(d->elements[degree_pos].classrooms[index-1].students, student_copy);
-
-				// Actualitzo la capacitat.
-				d->elements[degree_pos].classrooms[index-1].current_capacity++;
-				
-				// Resetejo i i la j.
-				i = 0;
-				j = 0;
-
-				// Faig un bucle while per eliminar el estudiant que ha estat mogut.
-				while(i<d->elements[degree_pos].classrooms[classroom_pos].current_capacity){
-
-					// Comprovo si la posició original del estudiant es diferent de i per actualitzar la llista d'estudiants de la classe.
-					if(i == student_pos_copy){
-						// Elimino el estudiant amb la funció LINKEDLIST_remove.
-                        LINKEDLIST_remove(d->elements[degree_pos].classrooms[classroom_pos].students);
-					}
-					// Avanço el POV de la llista per trobar la posicio del estudiant a eliminar.
-                    LINKEDLIST_next(d->elements[degree_pos].classrooms[classroom_pos].students);
-					i++;
-				}
-				// Resto 1 a la capacitat de la classe original del estudiant.
-				d->elements[degree_pos].classrooms[classroom_pos].current_capacity--;
+		if(*command == '\0' || *command == '#'){
+			// Línia buida o comentari.
+		}
+		else if(strcmp(command, "summary") == 0){
+			summaryOption(d);
+		}
+		else if(strcmp(command, "show") == 0){
+			showDegree(d, args);
+		}
+		else if(strcmp(command, "move") == 0){
+			if(sscanf(args, "%s %d %n", login, &index, &consumed) < 2 || !findDegree(d, args + consumed, &degree_pos)
+				|| !moveStudent(d, degree_pos, login, index)){
+				printf("\nERROR: Can't move student\n");
+				failed++;
 			}
-			else{
-				error = 1;
+		}
+		else if(strcmp(command, "bulkmove") == 0){
+			if(bulkMove(d, args) != 0){
+				failed++;
+			}
+		}
+		else if(strcmp(command, "save") == 0){
+			if(!saveSnapshot(d, args)){
+				failed++;
+			}
+		}
+		else if(strcmp(command, "export") == 0){
+			if(!exportDistribution(d, args)){
+				failed++;
+			}
+		}
+		else if(strcmp(command, "compact") == 0){
+			if(!journalCompact(d)){
+				failed++;
+			}
+		}
+		else if(strcmp(command, "stress") == 0){
+			if(sscanf(args, "%d %d", &readers, &moves) < 2 || !stressTest(d, readers, moves)){
+				failed++;
 			}
 		}
+		else if(strcmp(command, "metrics") == 0){
+			METRICS_report(stdout);
+		}
+		else if(strcmp(command, "exit") == 0){
+			continua = 0;
+		}
 		else{
-			error = 1;
+			printf("\nERROR: Unknown command '%s' (line %d)\n", command, num_line);
+			failed++;
 		}
+		// Els moviments de la comanda passen al disc en lots.
+		journalCommit(d, 0);
 	}
-	else{
-		error = 1;
-	}
-	// En cas de que les dades introduides no siguin correctes es mostra l'error.
-	if (error){
-		printf("\nERROR: Can't move student\n");
-
-	}
+	journalCommit(d, 1);
+	return(failed);
 }
 /*********************************************** 
 *
@@ -442,37 +3406,241 @@ void dealocation(Degrees **d){
 	// Faig dos bucles for per alliberar la memòria on estaven emmagatzemats els studiants.
 	for(i=0;i<(*d)->num_degrees;i++){
 		for(j=0;j<(*d)->elements[i].num_classrooms;j++){
-			//Allibero la memoria de la llista destruintla amb la funció LINKEDLIST_destroy.
-			LINKEDLIST_destroy(&((*d)->elements[i].classrooms[j].students));
+			// Allibero la llista sense recórrer-la amb la funció LINKEDLIST_release: els seus nodes 
+			// surten del pool i s'alliberen tots de cop amb el pool.
+			LINKEDLIST_release(&((*d)->elements[i].classrooms[j].students));
+			SKIPLIST_destroy(&((*d)->elements[i].classrooms[j].by_login));
+			pthread_rwlock_destroy(&((*d)->elements[i].classrooms[j].lock));
 		}
 	}
-	// Faig un bucle for per alliberar la memòria on estaven emmagatzemades les classes.
+	// Allibero de cop tots els nodes de les llistes amb la funció LINKEDLIST_destroyPool.
+	LINKEDLIST_destroyPool(&((*d)->pool));
+
+	// Faig un bucle for per alliberar la memòria on estaven emmagatzemades les classes, els heaps 
+	// i les sortides preparades.
 	for(i=0;i<(*d)->num_degrees;i++){
 		free((*d)->elements[i].classrooms);
+		free((*d)->elements[i].heap);
+		cacheFree(&((*d)->elements[i].summary));
+		cacheFree(&((*d)->elements[i].show));
+		pthread_mutex_destroy(&((*d)->elements[i].cache_lock));
 	}
-	// Allibero la memòria on estava emmagatzemada la informació dels graus.
+	cacheFree(&((*d)->summary));
+	pthread_mutex_destroy(&((*d)->summary_lock));
+	// Allibero la memòria on estava emmagatzemada la informació dels graus i els índexs.
 	free((*d)->elements);
+	STRINGTABLE_destroy(&((*d)->strings));
+	free((*d)->degree_of);
+	free((*d)->location_of);
+	free((*d)->locations);
 	// Allibero la memòria on estaven emmagatzemats els graus.
 	free((*d));
 }
 /*********************************************** 
 *
+* @Finalitat: Obrir i llegir el fitxer de classes, o un snapshot amb les classes i els estudiants. 
+			  Si el format no és correcte, s'allibera el que s'ha llegit i "d" queda buit, a punt 
+			  per tornar-ho a provar.
+
+* @Paràmetres: in: file_name = nom del fitxer.
+			   in/out: d = Punter a Punter a Degree que permet modificar el contingut de "d" fora del main.
+			   out: snapshot = 1 si el fitxer era un snapshot (ja no cal el fitxer d'estudiants), 0 si no.
+* @Retorn: correct = 1 si s'ha llegit el fitxer, 0 en cas contrari.
+*
+* **********************************************/
+int loadClassrooms(char file_name[], Degrees **d, int *snapshot){
+	int correct = 0;						// Variable flag que determina si el fitxer és correcte.
+	MappedFile f1;							// Fitxer mapejat a memòria.
+
+	// Obro el fitxer i el mapejo a memòria.
+	f1 = MAPPEDFILE_open(file_name);
+
+	//Crido la funció correctFile per comprovar si el fitxer s'ha obert correctament.		
+	correctFile(&correct, f1);
+
+	// Comprovo que el fitxer s'ha obert correctament.
+	*snapshot = 0;
+	if(correct){
+		// Crido la funció readSnapshot o readFileOne per llegir el fitxer e inicialitzar la memòria.
+		*snapshot = isSnapshot(f1);
+		if(*snapshot){
+			correct = readSnapshot(f1, file_name, d);
+		}
+		else{
+			correct = readFileOne(f1, file_name, d);
+		}
+		// Tanco el fitxer
+		MAPPEDFILE_close(&f1);
+
+		// Si el format no és correcte, allibero el que s'ha llegit.
+		if(!correct){
+			dealocation(d);
+			*d = (Degrees *) malloc(sizeof(Degrees));
+		}
+	}
+	else{
+		// En cas de que no es pugui obrir el fitxer es printa el missatge d'error.
+		printf("\nERROR: Can't open file '%s'\n", file_name);
+	}
+	return(correct);
+}
+/*********************************************** 
+*
+* @Finalitat: Obrir i llegir el fitxer d'estudiants. Si el format no és correcte ja s'ha 
+			  mostrat l'error i es treballa amb els estudiants llegits fins aleshores.
+
+* @Paràmetres: in: file_name = nom del fitxer.
+			   in/out: d = Punter a Punter a Degree que permet modificar el contingut de "d" fora del main.
+			   in: num_threads = nombre de fils per llegir el fitxer.
+* @Retorn: correct = 1 si s'ha pogut obrir el fitxer, 0 en cas contrari.
+*
+* **********************************************/
+int loadStudents(char file_name[], Degrees **d, int num_threads){
+	int correct = 0;						// Variable flag que determina si el fitxer s'ha obert.
+	int i = 0;								// Variable per al bucle for.
+	MappedFile f2;							// Fitxer mapejat a memòria.
+
+	// Obro el fitxer i el mapejo a memòria.
+	f2 = MAPPEDFILE_open(file_name);
+
+	//Crido la funció correctFile per comprovar si el fitxer s'ha obert correctament.
+	correctFile(&correct, f2);
+
+	// Comprovo que el fitxer s'ha obert correctament.
+	if(!correct){
+		printf("\nERROR: Can't open file '%s'\n", file_name);
+	}
+	else{
+		// Crido la funció readFileCsv, readFileTwo o la versió amb fils per llegir el fitxer.
+		if(isCsv(f2)){
+			readFileCsv(f2, file_name, d);
+		}
+		else if(num_threads > 1){
+			readFileTwoParallel(f2, file_name, d, num_threads);
+		}
+		else{
+			readFileTwo(f2, file_name, d);
+		}
+		// Tanco el fitxer
+		MAPPEDFILE_close(&f2);
+
+		// Els estudiants s'han afegit en l'ordre del fitxer: ordeno cada llista per login d'una vegada.
+		for(i=0;i<(*d)->num_degrees;i++){
+			sortRosters(*d, i);
+		}
+	}
+	return(correct);
+}
+/*********************************************** 
+*
 * @Finalitat: Executar el sistema (Funció Principal).
-* @Paràmetres: ----
-* @Retorn: ----
+* @Paràmetres: in: argc = nombre d'arguments.
+			   in: argv = arguments: [-t N] [-j journal] [classrooms students [script]]. Amb "-t N" el fitxer 
+			       d'estudiants es llegeix i es reparteix a les classes amb N fils (readFileTwoParallel). Amb "-j journal" els moviments s'apunten al journal i, en tornar a 
+			       arrencar, es tornen a aplicar. Si es donen els dos fitxers, el programa no 
+			       pregunta res i executa les comandes del fitxer script (o de l'entrada estàndard).
+			       En lloc dels dos fitxers es pot donar un snapshot: [-t N] snapshot [script].
+* @Retorn: 0 si tot ha anat bé, 1 si no s'han pogut llegir els fitxers.
 *
 * **********************************************/
-int main(){
+int main(int argc, char *argv[]){
 	int correct_class = 0, correct_student = 0;								// Variables flag que determinaràn si els fitxers son correctes.
 	char class_name[MAX_STRING_LENGTH], students_name[MAX_STRING_LENGTH];	// Cadenes on es guardarà el nom dels fitxers.
-	FILE *f1, *f2;															// Punters on es guardaran les direccions dels fitxers.
 	int continua = 1;														// Variable flag per al bucle while.
 	int op = 0;																// Variable que determinarà quina opció realitzar
 	Degrees *d;																// Punter a Degree on guardarà la direcció de tota l'structura d'arrays dinàmiques.
 	char trash;																// Variable per netejar el buffer.
+	int num_threads = 1;													// Nombre de fils per llegir el fitxer d'estudiants.
+	int i = 0;																// Variable per al bucle for.
+	char *files[3];															// Fitxers dels arguments: classes, estudiants i comandes.
+	int num_files = 0;														// Nombre de fitxers dels arguments.
+	FILE *script;															// Fitxer de comandes del mode no interactiu.
+	int status = 0;															// Valor de retorn del programa.
+	int snapshot = 0;														// Variable flag que indica si s'ha carregat un snapshot.
+	MappedFile first;														// Primer fitxer dels arguments, per saber si és un snapshot.
+	char *journal_name = NULL;												// Fitxer del journal de moviments o NULL si no n'hi ha.
+	int report = 0;															// Variable flag que val 1 si s'han de mostrar les mètriques en sortir.
+
+	// Llegeixo les opcions ("-t N" fils entre 1 i MAX_THREADS, "-j journal" i "-m" per mostrar les 
+	// mètriques en sortir) i els fitxers dels arguments.
+	for(i=1;i<argc;i++){
+		if(strcmp(argv[i], "-t") == 0 && i+1 < argc){
+			num_threads = atoi(argv[i+1]);
+			i++;
+		}
+		else if(strcmp(argv[i], "-j") == 0 && i+1 < argc){
+			journal_name = argv[i+1];
+			i++;
+		}
+		else if(strcmp(argv[i], "-m") == 0){
+			report = 1;
+		}
+		else if(num_files < 3){
+			files[num_files] = argv[i];
+			num_files++;
+		}
+	}
+	if(num_threads < 1){
+		num_threads = 1;
+	}
+	else if(num_threads > MAX_THREADS){
+		num_threads = MAX_THREADS;
+	}
 
 	// Reservo memòria per a d;
 	d = (Degrees *) malloc(sizeof(Degrees));
+
+	// Amb un sol fitxer als arguments, només és el mode no interactiu si és un snapshot.
+	if(num_files == 1){
+		first = MAPPEDFILE_open(files[0]);
+		if(first != NULL){
+			snapshot = isSnapshot(first);
+			MAPPEDFILE_close(&first);
+		}
+	}
+
+	// Mode no interactiu: llegeixo els fitxers dels arguments i executo les comandes.
+	if(num_files >= 2 || snapshot){
+		// La sortida s'escriu en blocs grans en lloc de línia a línia.
+		setvbuf(stdout, NULL, _IOFBF, OUTPUT_BUFFER);
+
+		if(!loadClassrooms(files[0], &d, &snapshot)){
+			free(d);
+			status = 1;
+		}
+		else{
+			// Amb un snapshot no hi ha fitxer d'estudiants i el fitxer de comandes és el segon.
+			i = snapshot ? 1 : 2;
+			if(!snapshot && !loadStudents(files[1], &d, num_threads)){
+				status = 1;
+			}
+			else if(journal_name != NULL && !journalOpen(d, journal_name, files[snapshot ? 0 : 1], snapshot)){
+				status = 1;
+			}
+			else{
+				// Sense fitxer de comandes (o amb "-"), les comandes es llegeixen de l'entrada estàndard.
+				script = (num_files > i && strcmp(files[i], "-") != 0) ? fopen(files[i], "r") : stdin;
+				if(script == NULL){
+					printf("\nERROR: Can't open file '%s'\n", files[i]);
+					status = 1;
+				}
+				else{
+					runScript(d, script);
+					if(script != stdin){
+						fclose(script);
+					}
+				}
+			}
+			journalClose(d);
+			dealocation(&d);
+		}
+		// Les mètriques van a stderr per no barrejar-les amb la sortida de les comandes.
+		if(report){
+			fflush(stdout);
+			METRICS_report(stderr);
+		}
+		return(status);
+	}
 	
 	printf("Welcome!\n");
 
@@ -482,61 +3650,37 @@ int main(){
 		printf("\nType the name of the 'classrooms' file: ");
 		scanf("%s", class_name);
 
-		// Obro el fitxer.
-		f1 = fopen(class_name, "r");
-
-		//Crido la funció correctFile per comprovar si el fitxer s'ha obert correctament.		
-		correctFile(&correct_class, f1);
-		
-		// Comprovo que el fitxer s'ha obert correctament.
-		if(correct_class){
-
-			// Crido la funció readFileOne per llegir el fitxer e inicialitzar la memòria.
-			readFileOne(f1, &d);
-			// Tanco el fitxer
-			fclose(f1);
+		// Crido la funció loadClassrooms per llegir el fitxer e inicialitzar la memòria.
+		correct_class = loadClassrooms(class_name, &d, &snapshot);
 
-			//Faig un bucle while per llegir el segon fitxer
-			while(!correct_student){
-				// Llegeixo el nom del fitxer que introdueix l'usuari.
-				printf("\nType the name of the 'students' file: ");
-				scanf("%s", students_name);
+		//Faig un bucle while per llegir el segon fitxer (un snapshot ja té els estudiants).
+		correct_student = snapshot;
+		while(correct_class && !correct_student){
+			// Llegeixo el nom del fitxer que introdueix l'usuari.
+			printf("\nType the name of the 'students' file: ");
+			scanf("%s", students_name);
 
-				// Obro el fitxer.
-				f2 = fopen(students_name, "r");		
-
-				//Crido la funció correctFile per comprovar si el fitxer s'ha obert correctament.
-				correctFile(&correct_student, f2);
-
-				// Comprovo que el fitxer s'ha obert correctament.
-				if(!correct_student){
-					printf("\nERROR: Can't open file '%s'\n", students_name);
-				}
-				else{
-					// Crido la funció readFileTwo per llegir el fitxer.
-					readFileTwo(f2, &d);
-					// Tanco el fitxer
-					fclose(f2);
-				}
-			}	
+			// Crido la funció loadStudents per llegir el fitxer.
+			correct_student = loadStudents(students_name, &d, num_threads);
 		}
-		else{
-			// En cas de que no es pugui obrir el fitxer es printa el missatge d'error.
-			printf("\nERROR: Can't open file '%s'\n",class_name);
-		}	
+	}
+
+	// Torno a aplicar els moviments del journal. Si no es pot obrir, es treballa sense journal.
+	if(journal_name != NULL){
+		journalOpen(d, journal_name, snapshot ? class_name : students_name, snapshot);
 	}
 	
 	// Faig un bucle while per a demanar la opció al usuari.
 	while(continua){
 
 		// Demano la opció al usuari.
-		printf("\n1. Summary | 2. Show degree students | 3. Move student | 4. Exit\nSelect option: ");
+		printf("\n1. Summary | 2. Show degree students | 3. Move student | 4. Exit | 5. Bulk move | 6. Save snapshot | 7. Compact journal | 8. Export | 9. Metrics\nSelect option: ");
 		scanf("%d", &op);
 		// Netejo el buffer per evitar errors.
 		scanf("%c", &trash);
 		
 		//Comprovo que la opció és correcta.
-		if(op>0 && op<5){
+		if(op>0 && op<10){
 			// Faig un switch amb op per realitzar la opció que introdueix l'usuari.
 			switch(op){
 				case 1:
@@ -558,7 +3702,34 @@ int main(){
 					printf("\nBye!\n");
 					// Finalitzo el bucle.
 					continua = 0;
+				break;
+
+				case 5:
+					// Crido la funció bulkMoveOption per executar la opció 5.
+					bulkMoveOption(d);
+				break;
+
+				case 6:
+					// Crido la funció saveSnapshotOption per executar la opció 6.
+					saveSnapshotOption(d);
+				break;
+
+				case 7:
+					// Crido la funció journalCompact per executar la opció 7.
+					journalCompact(d);
+				break;
+
+				case 8:
+					// Crido la funció exportOption per executar la opció 8.
+					exportOption(d);
+				break;
+
+				case 9:
+					// Crido la funció METRICS_report per executar la opció 9.
+					METRICS_report(stdout);
 			}
+			// Els moviments de l'opció passen al disc abans de demanar-ne una altra.
+			journalCommit(d, 1);
 		}
 		else{
 			// En el cas de que la opció no sigui correcta és printa el missatge d'error.
@@ -567,9 +3738,12 @@ int main(){
 
 	}
 
-	// Allibero tota la memòria reservada anteriorment amb la funció dealocation.
+	// Tanco el journal i allibero tota la memòria reservada anteriorment amb la funció dealocation.
+	journalClose(d);
 	dealocation(&d);
+	if(report){
+		METRICS_report(stderr);
+	}
 
-	return(0);
+	return(status);
 }
-œ
\ No newline at end of file
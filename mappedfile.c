@@ -0,0 +1,109 @@
+
+// Libraries
+#include <stdlib.h>					// To use dynamic memory.
+#include "mappedfile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * A mapped file keeps the descriptor of the open file and the address and
+ *  size of its content in memory. The operating system reads the pages of
+ *  the file on demand while they are accessed.
+ */
+struct mapped_t {
+	int fd;				// Descriptor of the open file;
+	char * data;		// Content of the file (NULL if empty);
+	long size;			// Size of the content;
+};
+
+
+/****************************************************************************
+ *
+ * @Objective: Opens a file and maps its whole content in memory (read only).
+ *			   Returns NULL if the file cannot be opened or mapped.
+ *
+ * @Parameters: (in)     path = path of the file to open
+ * @Return: The mapped file or NULL
+ *
+ ****************************************************************************/
+MappedFile MAPPEDFILE_open (const char* path) {
+	MappedFile file = NULL;
+	struct stat info;
+	int fd = open(path, O_RDONLY);
+
+	if (-1 != fd && 0 == fstat(fd, &info) && S_ISREG(info.st_mode)) {
+		file = (MappedFile) malloc (sizeof(struct mapped_t));
+		file->fd = fd;
+		file->size = (long) info.st_size;
+		file->data = NULL;
+
+		// An empty file cannot be mapped, but it is still a valid file.
+		if (0 < file->size) {
+			file->data = (char*) mmap(NULL, file->size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (MAP_FAILED == file->data) {
+				free(file);
+				file = NULL;
+			}
+			else {
+				// The file is read from the beginning to the end.
+				madvise(file->data, file->size, MADV_SEQUENTIAL);
+			}
+		}
+	}
+
+	if (NULL == file && -1 != fd) {
+		close(fd);
+	}
+
+	return file;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns the first byte of the content of the file. The content
+ *				is not ended with '\0', use MAPPEDFILE_size to know where it
+ *				ends. It is NULL for an empty file.
+ *
+ * @Parameters: (in)     file = the mapped file
+ * @Return: The content of the file
+ *
+ ****************************************************************************/
+const char* MAPPEDFILE_data (MappedFile file) {
+	return file->data;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns the number of bytes of the file.
+ *
+ * @Parameters: (in)     file = the mapped file
+ * @Return: The size of the file
+ *
+ ****************************************************************************/
+long	MAPPEDFILE_size (MappedFile file) {
+	return file->size;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Unmaps the content and closes the file. Any pointer to the
+ *				content is not valid anymore.
+ *
+ * @Parameters: (in/out) file = the mapped file to close.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	MAPPEDFILE_close (MappedFile* file) {
+	if (NULL != (*file)->data) {
+		munmap((*file)->data, (*file)->size);
+	}
+	close((*file)->fd);
+
+	free(*file);
+	*file = NULL;
+}
@@ -0,0 +1,74 @@
+/****************************************************************************
+ *
+ * @Objective: Mapped file implementation
+ *             A mapped file gives access to the whole content of a file as
+ *             a block of memory (mmap), so that it can be read without
+ *             copying it into buffers.
+ * @Author/s:  Pau Díaz Cuesta
+ *
+ * @Creation date: 17/10/2026
+ * @Last modification date: 17/10/2026
+ *
+ ****************************************************************************/
+
+// Define guard to prevent compilation problems if we add the module more
+//  than once in the project.
+#ifndef _MAPPEDFILE_H_
+#define _MAPPEDFILE_H_
+
+
+// Data types
+typedef struct mapped_t* MappedFile;
+
+
+// Procedures & Functions
+
+/****************************************************************************
+ *
+ * @Objective: Opens a file and maps its whole content in memory (read only).
+ *			   Returns NULL if the file cannot be opened or mapped.
+ *
+ * @Parameters: (in)     path = path of the file to open
+ * @Return: The mapped file or NULL
+ *
+ ****************************************************************************/
+MappedFile MAPPEDFILE_open (const char* path);
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns the first byte of the content of the file. The content
+ *				is not ended with '\0', use MAPPEDFILE_size to know where it
+ *				ends. It is NULL for an empty file.
+ *
+ * @Parameters: (in)     file = the mapped file
+ * @Return: The content of the file
+ *
+ ****************************************************************************/
+const char* MAPPEDFILE_data (MappedFile file);
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns the number of bytes of the file.
+ *
+ * @Parameters: (in)     file = the mapped file
+ * @Return: The size of the file
+ *
+ ****************************************************************************/
+long	MAPPEDFILE_size (MappedFile file);
+
+
+/****************************************************************************
+ *
+ * @Objective: Unmaps the content and closes the file. Any pointer to the
+ *				content is not valid anymore.
+ *
+ * @Parameters: (in/out) file = the mapped file to close.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	MAPPEDFILE_close (MappedFile* file);
+
+
+#endif
@@ -0,0 +1,132 @@
+
+// Libraries
+#include <time.h>					// To use the monotonic clock.
+#include <sys/resource.h>			// To get the peak memory of the process.
+#include "metrics.h"
+
+
+#ifdef ENABLE_METRICS
+
+/*
+ * Names of the counters and timers in the report, in the order of their
+ *  constants.
+ */
+static const char* counter_names[METRICS_COUNTERS] = {
+	"LINKEDLIST_add", "LINKEDLIST_remove", "LINKEDLIST_get", "LINKEDLIST_next", "nodes allocated"
+};
+
+static const char* timer_names[METRICS_TIMERS] = {
+	"readFileOne", "readFileTwo", "findDegree", "findLogin", "moveStudent"
+};
+
+/*
+ * A timer adds up the time of all its calls, in nanoseconds. The calls and
+ *  the total are added atomically, and every thread keeps the time when it
+ *  started each timer, so several threads can time the same code at once.
+ */
+typedef struct {
+	long long calls;				// Number of times it was stopped;
+	long long total;				// Time of all the calls;
+} Timer;
+
+long long METRICS_counters[METRICS_COUNTERS];
+
+static Timer timers[METRICS_TIMERS];
+
+static __thread long long started[METRICS_TIMERS];		// Time when this thread started each timer;
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns the time of the monotonic clock, which never goes
+ *				back (unlike the time of the day).
+ *
+ * @Parameters: ---
+ * @Return: The time in nanoseconds since an unspecified point
+ *
+ ****************************************************************************/
+static long long now () {
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (long long) t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+#endif
+
+
+/****************************************************************************
+ *
+ * @Objective: Starts a timer with the monotonic clock. A timer cannot be
+ *				started again before it is stopped. Use METRICS_START, which
+ *				is empty when the metrics are not compiled.
+ *
+ * @Parameters: (in)     timer = one of the timers defined
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	METRICS_start (int timer) {
+#ifdef ENABLE_METRICS
+	started[timer] = now();
+#else
+	(void) timer;
+#endif
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Stops a timer and adds the elapsed time to its total. Use
+ *				METRICS_STOP, which is empty when the metrics are not
+ *				compiled.
+ *
+ * @Parameters: (in)     timer = one of the timers defined
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	METRICS_stop (int timer) {
+#ifdef ENABLE_METRICS
+	__atomic_fetch_add(&(timers[timer].total), now() - started[timer], __ATOMIC_RELAXED);
+	__atomic_fetch_add(&(timers[timer].calls), 1, __ATOMIC_RELAXED);
+#else
+	(void) timer;
+#endif
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Writes a report with the peak memory of the process (resident
+ *				set size), every counter and, for every timer, the number of
+ *				calls, the total time and the average time of a call. If the
+ *				metrics are not compiled, it only writes the peak memory.
+ *
+ * @Parameters: (in/out) f = the file where to write the report
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	METRICS_report (FILE* f) {
+	struct rusage usage;
+#ifdef ENABLE_METRICS
+	int i = 0;
+	long long calls = 0, total = 0;
+#endif
+
+	getrusage(RUSAGE_SELF, &usage);
+	fprintf(f, "\nMetrics\n");
+	fprintf(f, "%-18s %14ld\n", "peak RSS (KB)", usage.ru_maxrss);
+#ifdef ENABLE_METRICS
+	for (i = 0; i < METRICS_COUNTERS; i++) {
+		fprintf(f, "%-18s %14lld\n", counter_names[i], __atomic_load_n(&(METRICS_counters[i]), __ATOMIC_RELAXED));
+	}
+	fprintf(f, "%-18s %14s %12s %12s\n", "timer", "calls", "total ms", "avg us");
+	for (i = 0; i < METRICS_TIMERS; i++) {
+		calls = __atomic_load_n(&(timers[i].calls), __ATOMIC_RELAXED);
+		total = __atomic_load_n(&(timers[i].total), __ATOMIC_RELAXED);
+		fprintf(f, "%-18s %14lld %12.3f %12.3f\n", timer_names[i], calls, total / 1e6,
+				(calls > 0) ? total / 1e3 / calls : 0.0);
+	}
+#else
+	fprintf(f, "Counters and timers are not enabled (build with make METRICS=1)\n");
+#endif
+}
@@ -0,0 +1,103 @@
+/****************************************************************************
+ *
+ * @Objective: Metrics implementation
+ *             Counters of the linked list operations and timers of the
+ *             load, lookup and move paths, to see where the time of a
+ *             session goes. They are only compiled when ENABLE_METRICS is
+ *             defined (make METRICS=1); otherwise the macros are empty and
+ *             cost nothing.
+ * @Author/s:  Pau Díaz Cuesta
+ *
+ * @Creation date: 17/10/2026
+ * @Last modification date: 17/10/2026
+ *
+ ****************************************************************************/
+
+// Define guard to prevent compilation problems if we add the module more
+//  than once in the project.
+#ifndef _METRICS_H_
+#define _METRICS_H_
+
+#include <stdio.h>
+
+
+// Counters.
+#define METRIC_LIST_ADD 0			// Elements added to a linked list.
+#define METRIC_LIST_REMOVE 1		// Elements removed from a linked list.
+#define METRIC_LIST_GET 2			// Elements read from a linked list (get or peek).
+#define METRIC_LIST_NEXT 3			// Moves of the POV or of an iterator of a linked list.
+#define METRIC_LIST_NODES 4			// Nodes handed out by malloc or a node pool.
+#define METRICS_COUNTERS 5
+
+// Timers.
+#define TIMER_READ_FILE_ONE 0		// Reading the classrooms file.
+#define TIMER_READ_FILE_TWO 1		// Reading the students file (any format).
+#define TIMER_FIND_DEGREE 2			// Looking for a degree by name.
+#define TIMER_FIND_LOGIN 3			// Looking for a student by login.
+#define TIMER_MOVE_STUDENT 4		// Moving a student (menu option or command).
+#define METRICS_TIMERS 5
+
+
+#ifdef ENABLE_METRICS
+
+// The counters are incremented atomically (relaxed, they do not order any
+//  other memory access), so they are exact also when reader threads walk
+//  the lists at the same time (stress command).
+extern long long METRICS_counters[METRICS_COUNTERS];
+
+#define METRICS_COUNT(counter, n)	__atomic_fetch_add(&(METRICS_counters[(counter)]), (n), __ATOMIC_RELAXED)
+#define METRICS_START(timer)		METRICS_start(timer)
+#define METRICS_STOP(timer)			METRICS_stop(timer)
+
+#else
+
+#define METRICS_COUNT(counter, n)
+#define METRICS_START(timer)
+#define METRICS_STOP(timer)
+
+#endif
+
+
+// Procedures & Functions
+
+/****************************************************************************
+ *
+ * @Objective: Starts a timer with the monotonic clock. A timer cannot be
+ *				started again before it is stopped. Use METRICS_START, which
+ *				is empty when the metrics are not compiled.
+ *
+ * @Parameters: (in)     timer = one of the timers defined
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	METRICS_start (int timer);
+
+
+/****************************************************************************
+ *
+ * @Objective: Stops a timer and adds the elapsed time to its total. Use
+ *				METRICS_STOP, which is empty when the metrics are not
+ *				compiled.
+ *
+ * @Parameters: (in)     timer = one of the timers defined
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	METRICS_stop (int timer);
+
+
+/****************************************************************************
+ *
+ * @Objective: Writes a report with the peak memory of the process (resident
+ *				set size), every counter and, for every timer, the number of
+ *				calls, the total time and the average time of a call. If the
+ *				metrics are not compiled, it only writes the peak memory.
+ *
+ * @Parameters: (in/out) f = the file where to write the report
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	METRICS_report (FILE* f);
+
+
+#endif
@@ -0,0 +1,391 @@
+
+// Libraries
+#include <stdlib.h>					// To use dynamic memory.
+#include "skiplist.h"
+
+/*
+ * Maximum number of levels of a skip list. With one node out of four going
+ *  up one level, 16 levels are enough for 4^16 elements.
+ */
+#define SKIP_MAX_LEVEL 16
+
+
+/*
+ * Every element of the skip list is in the level 0 chain, in order. One out
+ *  of four elements (chosen at random) is also in the level 1 chain, one out
+ *  of four of those in the level 2 chain, and so on, so the upper chains
+ *  skip over many elements at once:
+ *
+ *  level 2   head ---------------------------------> 40 ---------> NULL
+ *  level 1   head -----------> 17 -----------------> 40 ---------> NULL
+ *  level 0   head --> 3 --> 9 --> 17 --> 21 --> 33 --> 40 --> 52 --> NULL
+ *
+ * A search starts at the top chain and goes down a level every time the
+ *  next element would go after the one it looks for. Every element keeps
+ *  the node of the linked list where it is.
+ */
+typedef struct _SkipNode {
+	Element element;
+	ListNode node;					// Node of the element in the linked list;
+	int levels;						// Number of chains where the element is;
+	struct _SkipNode * next[1];		// Next element in each chain (levels);
+} SkipNode;
+
+struct skip_t {
+	int error;						// Error code to keep track of failing operations;
+	SkipNode * head[SKIP_MAX_LEVEL];	// First element of each chain;
+	SkipNode * last[SKIP_MAX_LEVEL];	// Last element of each chain, for the appends;
+	int levels;						// Number of chains in use;
+	int size;						// Number of elements;
+	unsigned int seed;				// State of the random levels;
+	ElementCompare compare;			// Order of the elements;
+	void * context;					// Passed as is to the compare function;
+};
+
+
+/****************************************************************************
+ *
+ * @Objective: Chooses the number of levels of a new element: one more level
+ *				with a probability of 1/4 each time (xorshift random numbers,
+ *				so the same operations always build the same skip list).
+ *
+ * @Parameters: (in/out) list = the skip list
+ * @Return: The number of levels, between 1 and SKIP_MAX_LEVEL
+ *
+ ****************************************************************************/
+static int randomLevels (SkipList list) {
+	int levels = 1;
+
+	list->seed ^= list->seed << 13;
+	list->seed ^= list->seed >> 17;
+	list->seed ^= list->seed << 5;
+	while (levels < SKIP_MAX_LEVEL && 0 == ((list->seed >> (2 * levels)) & 3)) {
+		levels++;
+	}
+	return levels;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Requests a new element with a random number of levels.
+ *
+ * @Parameters: (in/out) list    = the skip list
+ *				(in)     element = the element
+ *				(in)     node    = the node of the element in the linked list
+ * @Return: The new element or NULL if the malloc failed
+ *
+ ****************************************************************************/
+static SkipNode* newNode (SkipList list, Element element, ListNode node) {
+	int levels = randomLevels(list);
+	SkipNode* aux = (SkipNode*) malloc (sizeof(SkipNode) + sizeof(SkipNode*) * (levels - 1));
+
+	if (NULL != aux) {
+		aux->element = element;
+		aux->node = node;
+		aux->levels = levels;
+	}
+	return aux;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Finds, in every chain, the last element that goes before the
+ *				given one.
+ *
+ * @Parameters: (in)     list     = the skip list
+ *				(in)     element  = the element to look for
+ *				(out)    previous = for every level in use, the last element
+ *									that goes before (NULL for the head)
+ * @Return: ---
+ *
+ ****************************************************************************/
+static void findPrevious (SkipList list, const Element* element, SkipNode* previous[]) {
+	SkipNode* aux = NULL;
+	SkipNode* next = NULL;
+	int level = 0;
+
+	for (level = list->levels - 1; level >= 0; level--) {
+		next = (NULL == aux) ? list->head[level] : aux->next[level];
+		while (NULL != next && list->compare(&(next->element), element, list->context) < 0) {
+			aux = next;
+			next = next->next[level];
+		}
+		previous[level] = aux;
+	}
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns the link of a chain that points to the element after
+ *				the given one (the head of the chain if it is NULL).
+ *
+ * @Parameters: (in/out) list     = the skip list
+ *				(in)     previous = an element of the chain or NULL
+ *				(in)     level    = the chain
+ * @Return: The link to change to add or remove an element after previous
+ *
+ ****************************************************************************/
+static SkipNode** linkAfter (SkipList list, SkipNode* previous, int level) {
+	return (NULL == previous) ? &(list->head[level]) : &(previous->next[level]);
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Creates an empty skip list that keeps the elements in the
+ *				order of the compare function.
+ *			   If the skip list fails to get its memory, it will set the
+ *				error code to SKIP_ERROR_MALLOC.
+ *
+ * @Parameters: (in)     compare = the order of the indexed linked list
+ *				(in)     context = passed as is to the compare function
+ * @Return: An empty skip list
+ *
+ ****************************************************************************/
+SkipList SKIPLIST_create (ElementCompare compare, void* context) {
+	SkipList list = (SkipList) malloc (sizeof(struct skip_t));
+	int level = 0;
+
+	if (NULL != list) {
+		for (level = 0; level < SKIP_MAX_LEVEL; level++) {
+			list->head[level] = NULL;
+			list->last[level] = NULL;
+		}
+		list->levels = 1;
+		list->size = 0;
+		list->seed = 2463534242u;
+		list->compare = compare;
+		list->context = context;
+		list->error = SKIP_NO_ERROR;
+	}
+
+	return list;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Stores an element and the node of the linked list where it
+ *				is. The element must not be in the skip list yet.
+ *			   If the skip list fails to get memory for the element, it will
+ *				set the error code to SKIP_ERROR_MALLOC.
+ *
+ * @Parameters: (in/out) list    = the skip list
+ *				(in)     element = the element
+ *				(in)     node    = the node of the element in the linked list
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	SKIPLIST_insert (SkipList list, Element element, ListNode node) {
+	SkipNode* previous[SKIP_MAX_LEVEL];
+	SkipNode** link = NULL;
+	SkipNode* aux = newNode(list, element, node);
+	int level = 0;
+
+	if (NULL == aux) {
+		list->error = SKIP_ERROR_MALLOC;
+	}
+	else {
+		// 1- The new chains start at the head.
+		if (list->levels < aux->levels) {
+			list->levels = aux->levels;
+		}
+		findPrevious(list, &element, previous);
+
+		// 2- Link the element in each of its chains.
+		for (level = 0; level < aux->levels; level++) {
+			link = linkAfter(list, previous[level], level);
+			aux->next[level] = *link;
+			*link = aux;
+			if (NULL == aux->next[level]) {
+				list->last[level] = aux;
+			}
+		}
+		list->size++;
+		list->error = SKIP_NO_ERROR;
+	}
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Same as SKIPLIST_insert, for an element that does not go
+ *				before any element of the skip list. It does not compare any
+ *				element, so a skip list is built in one pass from a sorted
+ *				linked list.
+ *
+ * @Parameters: (in/out) list    = the skip list
+ *				(in)     element = the element
+ *				(in)     node    = the node of the element in the linked list
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	SKIPLIST_append (SkipList list, Element element, ListNode node) {
+	SkipNode* aux = newNode(list, element, node);
+	int level = 0;
+
+	if (NULL == aux) {
+		list->error = SKIP_ERROR_MALLOC;
+	}
+	else {
+		// Link the element after the last element of each of its chains.
+		for (level = 0; level < aux->levels; level++) {
+			aux->next[level] = NULL;
+			if (NULL == list->last[level]) {
+				list->head[level] = aux;
+			}
+			else {
+				list->last[level]->next[level] = aux;
+			}
+			list->last[level] = aux;
+		}
+		if (list->levels < aux->levels) {
+			list->levels = aux->levels;
+		}
+		list->size++;
+		list->error = SKIP_NO_ERROR;
+	}
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Removes an element from the skip list.
+ *			   If the element is not in the skip list, this operation will
+ *				return NULL and set the error code to SKIP_ERROR_NOT_FOUND.
+ *
+ * @Parameters: (in/out) list    = the skip list
+ *				(in)     element = the element to remove
+ * @Return: The node of the element in the linked list or NULL
+ *
+ ****************************************************************************/
+ListNode SKIPLIST_remove (SkipList list, const Element* element) {
+	SkipNode* previous[SKIP_MAX_LEVEL];
+	SkipNode* aux = NULL;
+	ListNode node = NULL;
+	int level = 0;
+
+	findPrevious(list, element, previous);
+	aux = *linkAfter(list, previous[0], 0);
+	if (NULL == aux || 0 != list->compare(&(aux->element), element, list->context)) {
+		list->error = SKIP_ERROR_NOT_FOUND;
+	}
+	else {
+		// 1- Unlink the element from each of its chains. The element is
+		//    right after the previous one in all of them.
+		for (level = 0; level < aux->levels; level++) {
+			*linkAfter(list, previous[level], level) = aux->next[level];
+			if (list->last[level] == aux) {
+				list->last[level] = previous[level];
+			}
+		}
+		// 2- Forget the empty chains at the top.
+		while (list->levels > 1 && NULL == list->head[list->levels - 1]) {
+			list->levels--;
+		}
+		node = aux->node;
+		free(aux);
+		list->size--;
+		list->error = SKIP_NO_ERROR;
+	}
+
+	return node;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns the node of the last element that goes before the
+ *				given one. With LINKEDLIST_goAfterNode, it puts the POV of the
+ *				linked list on the element, or where it must be added to keep
+ *				the linked list sorted.
+ *
+ * @Parameters: (in)     list    = the skip list
+ *				(in)     element = the element to look for
+ * @Return: The node of the previous element or NULL if no element goes before
+ *
+ ****************************************************************************/
+ListNode SKIPLIST_findBefore (SkipList list, const Element* element) {
+	SkipNode* previous[SKIP_MAX_LEVEL];
+
+	findPrevious(list, element, previous);
+	return (NULL == previous[0]) ? NULL : previous[0]->node;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns the number of elements in the skip list.
+ *
+ * @Parameters: (in)     list = the skip list to check
+ * @Return: The number of elements
+ *
+ ****************************************************************************/
+int		SKIPLIST_size (SkipList list) {
+	return list->size;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Removes all the elements from the skip list, which can be
+ *				used again (e.g. to build it again after sorting the linked
+ *				list).
+ *
+ * @Parameters: (in/out) list = the skip list to clear.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	SKIPLIST_clear (SkipList list) {
+	SkipNode* aux = NULL;
+	int level = 0;
+
+	// Every element is in the level 0 chain.
+	while (NULL != list->head[0]) {
+		aux = list->head[0];
+		list->head[0] = aux->next[0];
+		free(aux);
+	}
+	for (level = 0; level < SKIP_MAX_LEVEL; level++) {
+		list->head[level] = NULL;
+		list->last[level] = NULL;
+	}
+	list->levels = 1;
+	list->size = 0;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Removes all the elements from the skip list and frees any
+ *				dynamic memory block it was using. The skip list must be
+ *				created again before usage.
+ *
+ * @Parameters: (in/out) list = the skip list to destroy.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	SKIPLIST_destroy (SkipList* list) {
+	SKIPLIST_clear(*list);
+
+	free(*list);
+	*list = NULL;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: This function returns the error code provided by the last
+ *				operation run. The operations that update the error code are:
+ *				Create, Insert, Append and Remove.
+ *
+ * @Parameters: (in)     list = the skip list to check.
+ * @Return: an error code from the list of constants defined.
+ *
+ ****************************************************************************/
+int		SKIPLIST_getErrorCode (SkipList list) {
+	return list->error;
+}
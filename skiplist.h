@@ -0,0 +1,162 @@
+/****************************************************************************
+ *
+ * @Objective: Skip list data structure implementation
+ *             A skip list is an index of the nodes of a sorted linked list.
+ *             It finds where an element is (or where it should go) in the
+ *             linked list comparing only about log(n) elements, instead of
+ *             walking the linked list from the head.
+ * @Author/s:  Pau Díaz Cuesta
+ *
+ * @Creation date: 17/10/2026
+ * @Last modification date: 17/10/2026
+ *
+ ****************************************************************************/
+
+// Define guard to prevent compilation problems if we add the module more
+//  than once in the project.
+#ifndef _SKIPLIST_H_
+#define _SKIPLIST_H_
+
+// The skip list indexes the nodes of a linked list, so it uses its element,
+//  node and compare types.
+#include "linkedlist.h"
+
+
+// Constants to manage the skip list's error codes.
+#define SKIP_NO_ERROR 0
+#define SKIP_ERROR_MALLOC 1			// Error, a malloc failed.
+#define SKIP_ERROR_NOT_FOUND 2		// Error, the element is not in the index.
+
+// Data types
+typedef struct skip_t* SkipList;
+
+
+// Procedures & Functions
+
+/****************************************************************************
+ *
+ * @Objective: Creates an empty skip list that keeps the elements in the
+ *				order of the compare function.
+ *			   If the skip list fails to get its memory, it will set the
+ *				error code to SKIP_ERROR_MALLOC.
+ *
+ * @Parameters: (in)     compare = the order of the indexed linked list
+ *				(in)     context = passed as is to the compare function
+ * @Return: An empty skip list
+ *
+ ****************************************************************************/
+SkipList SKIPLIST_create (ElementCompare compare, void* context);
+
+
+/****************************************************************************
+ *
+ * @Objective: Stores an element and the node of the linked list where it
+ *				is. The element must not be in the skip list yet.
+ *			   If the skip list fails to get memory for the element, it will
+ *				set the error code to SKIP_ERROR_MALLOC.
+ *
+ * @Parameters: (in/out) list    = the skip list
+ *				(in)     element = the element
+ *				(in)     node    = the node of the element in the linked list
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	SKIPLIST_insert (SkipList list, Element element, ListNode node);
+
+
+/****************************************************************************
+ *
+ * @Objective: Same as SKIPLIST_insert, for an element that does not go
+ *				before any element of the skip list. It does not compare any
+ *				element, so a skip list is built in one pass from a sorted
+ *				linked list.
+ *
+ * @Parameters: (in/out) list    = the skip list
+ *				(in)     element = the element
+ *				(in)     node    = the node of the element in the linked list
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	SKIPLIST_append (SkipList list, Element element, ListNode node);
+
+
+/****************************************************************************
+ *
+ * @Objective: Removes an element from the skip list.
+ *			   If the element is not in the skip list, this operation will
+ *				return NULL and set the error code to SKIP_ERROR_NOT_FOUND.
+ *
+ * @Parameters: (in/out) list    = the skip list
+ *				(in)     element = the element to remove
+ * @Return: The node of the element in the linked list or NULL
+ *
+ ****************************************************************************/
+ListNode SKIPLIST_remove (SkipList list, const Element* element);
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns the node of the last element that goes before the
+ *				given one. With LINKEDLIST_goAfterNode, it puts the POV of the
+ *				linked list on the element, or where it must be added to keep
+ *				the linked list sorted.
+ *
+ * @Parameters: (in)     list    = the skip list
+ *				(in)     element = the element to look for
+ * @Return: The node of the previous element or NULL if no element goes before
+ *
+ ****************************************************************************/
+ListNode SKIPLIST_findBefore (SkipList list, const Element* element);
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns the number of elements in the skip list.
+ *
+ * @Parameters: (in)     list = the skip list to check
+ * @Return: The number of elements
+ *
+ ****************************************************************************/
+int		SKIPLIST_size (SkipList list);
+
+
+/****************************************************************************
+ *
+ * @Objective: Removes all the elements from the skip list, which can be
+ *				used again (e.g. to build it again after sorting the linked
+ *				list).
+ *
+ * @Parameters: (in/out) list = the skip list to clear.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	SKIPLIST_clear (SkipList list);
+
+
+/****************************************************************************
+ *
+ * @Objective: Removes all the elements from the skip list and frees any
+ *				dynamic memory block it was using. The skip list must be
+ *				created again before usage.
+ *
+ * @Parameters: (in/out) list = the skip list to destroy.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	SKIPLIST_destroy (SkipList* list);
+
+
+/****************************************************************************
+ *
+ * @Objective: This function returns the error code provided by the last
+ *				operation run. The operations that update the error code are:
+ *				Create, Insert, Append and Remove.
+ *
+ * @Parameters: (in)     list = the skip list to check.
+ * @Return: an error code from the list of constants defined.
+ *
+ ****************************************************************************/
+int		SKIPLIST_getErrorCode (SkipList list);
+
+
+#endif
@@ -0,0 +1,21 @@
+/****************************************************************************
+ *
+ * @Objective: Handle of a text stored in a string table (see stringtable.h).
+ *             It is kept apart so that the modules that only store handles,
+ *             as the elements of a LinkedList, do not depend on the table.
+ * @Author/s:  Pau Díaz Cuesta
+ *
+ * @Creation date: 17/10/2026
+ * @Last modification date: 17/10/2026
+ *
+ ****************************************************************************/
+
+// Define guard to prevent compilation problems if we add the module more
+//  than once in the project.
+#ifndef _STRINGID_H_
+#define _STRINGID_H_
+
+// Data types
+typedef int StringId;
+
+#endif
@@ -0,0 +1,555 @@
+
+// Libraries
+#include <stdlib.h>					// To use dynamic memory.
+#include "stringtable.h"
+#include <string.h>
+
+/*
+ * Minimum number of slots and texts of a table. The number of slots is
+ *  always a power of two so that the slot of a hash can be found with a mask.
+ */
+#define STRING_MIN_SLOTS 16
+#define STRING_MIN_BYTES 256
+
+
+/*
+ * The string table stores all its texts one after the other, each one ended
+ *  with '\0', in a single block of characters. The handle of a text is its
+ *  position in the offsets array, which says where the text starts.
+ *
+ *            +---+---+---+---+---+---+---+---+---+---+---+---+
+ *  texts     | J | H | 1 |\0 | s | o | l | o |\0 | a | r | ...
+ *            +---+---+---+---+---+---+---+---+---+---+---+---+
+ *              ^               ^                   ^
+ *            +---+---+---+     |                   |
+ *  offsets   | 0 | 4 | 9 |-----+-------------------
+ *            +---+---+---+
+ *             id0 id1 id2
+ *
+ * To find the handle of a text, the table keeps an array of slots with the
+ *  handles (open addressing with linear probing, as the hash table), where
+ *  every slot takes only the 4 bytes of a handle.
+ */
+struct strtab_t {
+	int error;			// Error code to keep track of failing operations;
+	char * texts;		// Block with all the texts;
+	int texts_used;		// Bytes of the block already used;
+	int texts_capacity;	// Bytes of the block;
+	int * offsets;		// Where every text starts in the block;
+	int size;			// Number of texts stored;
+	int max_size;		// Number of texts the offsets array has room for;
+	StringId * slots;	// Handles of the texts by hash (STRING_NOT_FOUND = free);
+	int num_slots;		// Number of slots (power of two);
+};
+
+
+/****************************************************************************
+ *
+ * @Objective: Computes the hash of a text (FNV-1a).
+ *
+ * @Parameters: (in)     text   = the text
+ *				(in)     length = number of characters of the text
+ * @Return: The hash of the text
+ *
+ ****************************************************************************/
+static unsigned int hashText (const char* text, int length) {
+	unsigned int hash = 2166136261u;
+	int i = 0;
+
+	for (i = 0; i < length; i++) {
+		hash ^= (unsigned char) text[i];
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Compares a text stored in the table with a text that does not
+ *				need to be ended with '\0'.
+ *
+ * @Parameters: (in)     stored = text stored in the table (ended with '\0')
+ *				(in)     text   = the text to compare
+ *				(in)     length = number of characters of the text
+ * @Return: true (!0) if both texts are equal, false (0) otherwise
+ *
+ ****************************************************************************/
+static int equalText (const char* stored, const char* text, int length) {
+	int i = 0;
+
+	while (i < length && '\0' != stored[i] && stored[i] == text[i]) {
+		i++;
+	}
+
+	return i == length && '\0' == stored[i];
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns the slot where the handle of the text is stored or, if
+ *				the text is not in the table, the free slot where it should go.
+ *
+ * @Parameters: (in)     table  = the string table
+ *				(in)     text   = the text
+ *				(in)     length = number of characters of the text
+ * @Return: The slot of the text
+ *
+ ****************************************************************************/
+static StringId* findSlot (StringTable table, const char* text, int length) {
+	unsigned int mask = (unsigned int) table->num_slots - 1;
+	unsigned int i = hashText(text, length) & mask;
+
+	// There is always a free slot, so the loop always ends.
+	while (STRING_NOT_FOUND != table->slots[i] && !equalText(table->texts + table->offsets[table->slots[i]], text, length)) {
+		i = (i + 1) & mask;
+	}
+
+	return &(table->slots[i]);
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns the length of a text stored in the table.
+ *
+ * @Parameters: (in)     table = the string table
+ *				(in)     id    = handle of the text
+ * @Return: Number of characters of the text (without '\0')
+ *
+ ****************************************************************************/
+static int lengthOf (StringTable table, StringId id) {
+	int next = (id + 1 < table->size) ? table->offsets[id + 1] : table->texts_used;
+
+	return next - table->offsets[id] - 1;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Grows the slots of the table to the given number and puts
+ *				every handle in its new slot.
+ *
+ * @Parameters: (in/out) table     = the string table to grow
+ *				(in)     num_slots = new number of slots (power of two)
+ * @Return: true (!0) if the slots could be requested, false (0) otherwise
+ *
+ ****************************************************************************/
+static int growSlots (StringTable table, int num_slots) {
+	StringId* slots = (StringId*) malloc (sizeof(StringId) * num_slots);
+	unsigned int mask = (unsigned int) num_slots - 1;
+	unsigned int i = 0;
+	StringId id = 0;
+
+	if (NULL == slots) {
+		return 0;
+	}
+	for (i = 0; i < (unsigned int) num_slots; i++) {
+		slots[i] = STRING_NOT_FOUND;
+	}
+	// All the texts are different, so every handle only needs a free slot
+	//  and there is no text to compare.
+	for (id = 0; id < table->size; id++) {
+		i = hashText(table->texts + table->offsets[id], lengthOf(table, id)) & mask;
+		while (STRING_NOT_FOUND != slots[i]) {
+			i = (i + 1) & mask;
+		}
+		slots[i] = id;
+	}
+	free(table->slots);
+	table->slots = slots;
+	table->num_slots = num_slots;
+
+	return 1;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Makes sure there is room in the table for some more texts,
+ *				growing the blocks that are too small.
+ *
+ * @Parameters: (in/out) table = the string table
+ *				(in)     texts = number of new texts
+ *				(in)     bytes = number of characters of the new texts (with
+ *								 their '\0')
+ * @Return: true (!0) if there is room, false (0) otherwise
+ *
+ ****************************************************************************/
+static int makeRoomFor (StringTable table, int texts, long bytes) {
+	char* block = NULL;
+	int* offsets = NULL;
+	long capacity = 0;
+
+	// The slots are kept under 70% full.
+	capacity = table->num_slots;
+	while ((table->size + texts) * 10L > capacity * 7) {
+		capacity *= 2;
+	}
+	if (capacity > table->num_slots && !growSlots(table, (int) capacity)) {
+		return 0;
+	}
+
+	if (table->size + texts > table->max_size) {
+		capacity = table->max_size * 2L;
+		while (table->size + texts > capacity) {
+			capacity *= 2;
+		}
+		offsets = (int*) realloc (table->offsets, sizeof(int) * capacity);
+		if (NULL == offsets) {
+			return 0;
+		}
+		table->offsets = offsets;
+		table->max_size = (int) capacity;
+	}
+
+	if (table->texts_used + bytes > table->texts_capacity) {
+		capacity = table->texts_capacity * 2L;
+		while (table->texts_used + bytes > capacity) {
+			capacity *= 2;
+		}
+		block = (char*) realloc (table->texts, capacity);
+		if (NULL == block) {
+			return 0;
+		}
+		table->texts = block;
+		table->texts_capacity = (int) capacity;
+	}
+
+	return 1;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Creates an empty string table with room for the expected
+ *				number of texts. The table grows by itself if needed.
+ *			   If the table fails to get its memory, it will set the error
+ *				code to STRING_ERROR_MALLOC.
+ *
+ * @Parameters: (in)     expected = number of texts the table will hold
+ * @Return: An empty string table
+ *
+ ****************************************************************************/
+StringTable STRINGTABLE_create (int expected) {
+	StringTable table = (StringTable) malloc (sizeof(struct strtab_t));
+	int i = 0;
+
+	// We need enough slots to keep the table under 70% full.
+	table->num_slots = STRING_MIN_SLOTS;
+	while (table->num_slots * 7 < expected * 10) {
+		table->num_slots *= 2;
+	}
+	table->max_size = expected > STRING_MIN_SLOTS ? expected : STRING_MIN_SLOTS;
+	table->texts_capacity = STRING_MIN_BYTES;
+	table->texts_used = 0;
+	table->size = 0;
+
+	table->slots = (StringId*) malloc (sizeof(StringId) * table->num_slots);
+	table->offsets = (int*) malloc (sizeof(int) * table->max_size);
+	table->texts = (char*) malloc (table->texts_capacity);
+
+	if (NULL != table->slots && NULL != table->offsets && NULL != table->texts) {
+		for (i = 0; i < table->num_slots; i++) {
+			table->slots[i] = STRING_NOT_FOUND;
+		}
+		table->error = STRING_NO_ERROR;
+	}
+	else {
+		table->error = STRING_ERROR_MALLOC;
+	}
+
+	return table;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns the handle of the text, storing the text in the table
+ *				if it was not there yet. The handles are given in order: the
+ *				first text stored gets 0, the next one 1, and so on.
+ *			   If the table fails to get memory for the text, it will return
+ *				STRING_NOT_FOUND and set the error code to STRING_ERROR_MALLOC.
+ *
+ * @Parameters: (in/out) table = the string table where to store the text
+ *				(in)     text  = the text
+ * @Return: The handle of the text
+ *
+ ****************************************************************************/
+StringId STRINGTABLE_intern (StringTable table, const char* text) {
+	return STRINGTABLE_internN (table, text, strlen(text));
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Same as STRINGTABLE_intern, for a text that is not ended with
+ *				'\0' (e.g. a piece of a bigger buffer). The table stores its
+ *				own copy of the text, ended with '\0'.
+ *
+ * @Parameters: (in/out) table  = the string table where to store the text
+ *				(in)     text   = the first character of the text
+ *				(in)     length = number of characters of the text
+ * @Return: The handle of the text
+ *
+ ****************************************************************************/
+StringId STRINGTABLE_internN (StringTable table, const char* text, int length) {
+	StringId* slot = findSlot(table, text, length);
+	StringId* slots = table->slots;
+
+	table->error = STRING_NO_ERROR;
+
+	if (STRING_NOT_FOUND == *slot) {
+		if (makeRoomFor(table, 1, length + 1)) {
+			// If the slots have grown, we look for the free slot again.
+			if (slots != table->slots) {
+				slot = findSlot(table, text, length);
+			}
+			*slot = table->size;
+			table->offsets[table->size] = table->texts_used;
+			memcpy(table->texts + table->texts_used, text, length);
+			table->texts[table->texts_used + length] = '\0';
+			table->texts_used += length + 1;
+			table->size++;
+		}
+		else {
+			table->error = STRING_ERROR_MALLOC;
+		}
+	}
+
+	return *slot;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns the handle of the text without storing it.
+ *			   If the text is not in the table, this operation will return
+ *				STRING_NOT_FOUND and set the error code to
+ *				STRING_ERROR_NOT_FOUND.
+ *
+ * @Parameters: (in/out) table = the string table where to look for the text.
+ *								 in/out because we need to set the error code.
+ *				(in)     text  = the text to look for
+ * @Return: The handle of the text or STRING_NOT_FOUND
+ *
+ ****************************************************************************/
+StringId STRINGTABLE_find (StringTable table, const char* text) {
+	return STRINGTABLE_findN (table, text, strlen(text));
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Same as STRINGTABLE_find, for a text that is not ended with
+ *				'\0' (e.g. a piece of a bigger buffer).
+ *
+ * @Parameters: (in/out) table  = the string table where to look for the text.
+ *				(in)     text   = the first character of the text
+ *				(in)     length = number of characters of the text
+ * @Return: The handle of the text or STRING_NOT_FOUND
+ *
+ ****************************************************************************/
+StringId STRINGTABLE_findN (StringTable table, const char* text, int length) {
+	StringId id = *findSlot(table, text, length);
+
+	if (STRING_NOT_FOUND == id) {
+		table->error = STRING_ERROR_NOT_FOUND;
+	}
+	else {
+		table->error = STRING_NO_ERROR;
+	}
+
+	return id;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Same as STRINGTABLE_findN, but it does not update the error
+ *				code, so the table is only read. Several threads can look for
+ *				texts at the same time as long as no text is being stored.
+ *
+ * @Parameters: (in)     table  = the string table where to look for the text.
+ *				(in)     text   = the first character of the text
+ *				(in)     length = number of characters of the text
+ * @Return: The handle of the text or STRING_NOT_FOUND
+ *
+ ****************************************************************************/
+StringId STRINGTABLE_lookupN (StringTable table, const char* text, int length) {
+	return *findSlot(table, text, length);
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Makes room in the table for a number of new texts, so that
+ *				storing them does not need to grow (and move) the table.
+ *			   If the table fails to get the memory, it will set the error
+ *				code to STRING_ERROR_MALLOC (the texts can still be stored,
+ *				the table will try to grow again).
+ *
+ * @Parameters: (in/out) table = the string table
+ *				(in)     texts = number of new texts
+ *				(in)     bytes = number of characters of the new texts
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	STRINGTABLE_reserve (StringTable table, int texts, long bytes) {
+	if (makeRoomFor(table, texts, bytes + texts)) {
+		table->error = STRING_NO_ERROR;
+	}
+	else {
+		table->error = STRING_ERROR_MALLOC;
+	}
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns the text of a handle. The text must not be modified,
+ *				and the pointer is only valid until the next text is stored
+ *				(the table may move its texts when it grows).
+ *
+ * @Parameters: (in)     table = the string table
+ *				(in)     id    = a handle returned by the table
+ * @Return: The text of the handle
+ *
+ ****************************************************************************/
+const char* STRINGTABLE_get (StringTable table, StringId id) {
+	return table->texts + table->offsets[id];
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns the block with all the texts of the table, one after
+ *				the other in handle order and each one ended with '\0'. The
+ *				block must not be modified and is only valid until the next
+ *				text is stored.
+ *
+ * @Parameters: (in)     table = the string table
+ *				(out)    bytes = number of bytes of the block
+ * @Return: The block with the texts
+ *
+ ****************************************************************************/
+const char* STRINGTABLE_block (StringTable table, long* bytes) {
+	*bytes = table->texts_used;
+	return table->texts;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Creates a string table with the texts of a block returned by
+ *				STRINGTABLE_block, so that every text gets back the same
+ *				handle. The block is copied at once and only the slots are
+ *				computed again, there is no allocation for each text.
+ *			   If the table fails to get its memory, it will set the error
+ *				code to STRING_ERROR_MALLOC.
+ *
+ * @Parameters: (in)     block = texts ended with '\0', one after the other
+ *				(in)     bytes = number of bytes of the block
+ * @Return: A string table with the texts of the block
+ *
+ ****************************************************************************/
+StringTable STRINGTABLE_createFromBlock (const char* block, long bytes) {
+	StringTable table = NULL;
+	int count = 0;
+	long i = 0;
+
+	for (i = 0; i < bytes; i++) {
+		if ('\0' == block[i]) {
+			count++;
+		}
+	}
+
+	table = STRINGTABLE_create(count);
+	if (STRING_NO_ERROR == table->error) {
+		if (makeRoomFor(table, count, bytes)) {
+			memcpy(table->texts, block, bytes);
+			table->texts_used = (int) bytes;
+			// Every text starts after the '\0' of the previous one (a
+			//  last text without '\0' is not counted, the check fails).
+			for (i = 0; i < bytes && table->size < count; i++) {
+				if (0 == i || '\0' == block[i - 1]) {
+					table->offsets[table->size] = (int) i;
+					table->size++;
+				}
+			}
+		}
+		if (table->size != count || (bytes > 0 && '\0' != block[bytes - 1]) || !growSlots(table, table->num_slots)) {
+			table->error = STRING_ERROR_MALLOC;
+		}
+	}
+
+	return table;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns the number of different texts stored in the table.
+ *				Every handle is smaller than this number.
+ *
+ * @Parameters: (in)     table = the string table to check
+ * @Return: The number of texts in the table
+ *
+ ****************************************************************************/
+int		STRINGTABLE_size (StringTable table) {
+	return table->size;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns the number of bytes of dynamic memory the table is
+ *				using (texts, handles and slots).
+ *
+ * @Parameters: (in)     table = the string table to check
+ * @Return: The number of bytes used by the table
+ *
+ ****************************************************************************/
+long	STRINGTABLE_memory (StringTable table) {
+	return (long) table->texts_capacity + (long) sizeof(int) * table->max_size + (long) sizeof(StringId) * table->num_slots;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: Removes all the texts from the table and frees any dynamic
+ *				memory block the table was using. The table must be created
+ *				again before usage.
+ *
+ * @Parameters: (in/out) table = the string table to destroy.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	STRINGTABLE_destroy (StringTable* table) {
+	free((*table)->texts);
+	free((*table)->offsets);
+	free((*table)->slots);
+	(*table)->texts = NULL;
+	(*table)->offsets = NULL;
+	(*table)->slots = NULL;
+
+	free(*table);
+	*table = NULL;
+}
+
+
+/****************************************************************************
+ *
+ * @Objective: This function returns the error code provided by the last
+ *				operation run. The operations that update the error code are:
+ *				Create, Intern, Find and Reserve.
+ *
+ * @Parameters: (in)     table = the string table to check.
+ * @Return: an error code from the list of constants defined.
+ *
+ ****************************************************************************/
+int		STRINGTABLE_getErrorCode (StringTable table) {
+	return table->error;
+}
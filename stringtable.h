@@ -0,0 +1,240 @@
+/****************************************************************************
+ *
+ * @Objective: String table data structure implementation
+ *             A string table stores every different text only once and
+ *             identifies it with a small integer handle (StringId). Two
+ *             texts are equal if and only if their handles are equal, so
+ *             they can be compared without strcmp.
+ * @Author/s:  Pau Díaz Cuesta
+ *
+ * @Creation date: 17/10/2026
+ * @Last modification date: 17/10/2026
+ *
+ ****************************************************************************/
+
+// Define guard to prevent compilation problems if we add the module more
+//  than once in the project.
+#ifndef _STRINGTABLE_H_
+#define _STRINGTABLE_H_
+
+
+// Constants to manage the table's error codes.
+#define STRING_NO_ERROR 0
+#define STRING_ERROR_MALLOC 1		// Error, a malloc failed.
+#define STRING_ERROR_NOT_FOUND 2	// Error, the text is not in the table.
+
+// Handle returned when a text is not in the table.
+#define STRING_NOT_FOUND -1
+
+// Data types
+#include "stringid.h"
+
+typedef struct strtab_t* StringTable;
+
+
+// Procedures & Functions
+
+/****************************************************************************
+ *
+ * @Objective: Creates an empty string table with room for the expected
+ *				number of texts. The table grows by itself if needed.
+ *			   If the table fails to get its memory, it will set the error
+ *				code to STRING_ERROR_MALLOC.
+ *
+ * @Parameters: (in)     expected = number of texts the table will hold
+ * @Return: An empty string table
+ *
+ ****************************************************************************/
+StringTable STRINGTABLE_create (int expected);
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns the handle of the text, storing the text in the table
+ *				if it was not there yet. The handles are given in order: the
+ *				first text stored gets 0, the next one 1, and so on.
+ *			   If the table fails to get memory for the text, it will return
+ *				STRING_NOT_FOUND and set the error code to STRING_ERROR_MALLOC.
+ *
+ * @Parameters: (in/out) table = the string table where to store the text
+ *				(in)     text  = the text
+ * @Return: The handle of the text
+ *
+ ****************************************************************************/
+StringId STRINGTABLE_intern (StringTable table, const char* text);
+
+
+/****************************************************************************
+ *
+ * @Objective: Same as STRINGTABLE_intern, for a text that is not ended with
+ *				'\0' (e.g. a piece of a bigger buffer). The table stores its
+ *				own copy of the text, ended with '\0'.
+ *
+ * @Parameters: (in/out) table  = the string table where to store the text
+ *				(in)     text   = the first character of the text
+ *				(in)     length = number of characters of the text
+ * @Return: The handle of the text
+ *
+ ****************************************************************************/
+StringId STRINGTABLE_internN (StringTable table, const char* text, int length);
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns the handle of the text without storing it.
+ *			   If the text is not in the table, this operation will return
+ *				STRING_NOT_FOUND and set the error code to
+ *				STRING_ERROR_NOT_FOUND.
+ *
+ * @Parameters: (in/out) table = the string table where to look for the text.
+ *								 in/out because we need to set the error code.
+ *				(in)     text  = the text to look for
+ * @Return: The handle of the text or STRING_NOT_FOUND
+ *
+ ****************************************************************************/
+StringId STRINGTABLE_find (StringTable table, const char* text);
+
+
+/****************************************************************************
+ *
+ * @Objective: Same as STRINGTABLE_find, for a text that is not ended with
+ *				'\0' (e.g. a piece of a bigger buffer).
+ *
+ * @Parameters: (in/out) table  = the string table where to look for the text.
+ *				(in)     text   = the first character of the text
+ *				(in)     length = number of characters of the text
+ * @Return: The handle of the text or STRING_NOT_FOUND
+ *
+ ****************************************************************************/
+StringId STRINGTABLE_findN (StringTable table, const char* text, int length);
+
+
+/****************************************************************************
+ *
+ * @Objective: Same as STRINGTABLE_findN, but it does not update the error
+ *				code, so the table is only read. Several threads can look for
+ *				texts at the same time as long as no text is being stored.
+ *
+ * @Parameters: (in)     table  = the string table where to look for the text.
+ *				(in)     text   = the first character of the text
+ *				(in)     length = number of characters of the text
+ * @Return: The handle of the text or STRING_NOT_FOUND
+ *
+ ****************************************************************************/
+StringId STRINGTABLE_lookupN (StringTable table, const char* text, int length);
+
+
+/****************************************************************************
+ *
+ * @Objective: Makes room in the table for a number of new texts, so that
+ *				storing them does not need to grow (and move) the table.
+ *			   If the table fails to get the memory, it will set the error
+ *				code to STRING_ERROR_MALLOC (the texts can still be stored,
+ *				the table will try to grow again).
+ *
+ * @Parameters: (in/out) table = the string table
+ *				(in)     texts = number of new texts
+ *				(in)     bytes = number of characters of the new texts
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	STRINGTABLE_reserve (StringTable table, int texts, long bytes);
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns the text of a handle. The text must not be modified,
+ *				and the pointer is only valid until the next text is stored
+ *				(the table may move its texts when it grows).
+ *
+ * @Parameters: (in)     table = the string table
+ *				(in)     id    = a handle returned by the table
+ * @Return: The text of the handle
+ *
+ ****************************************************************************/
+const char* STRINGTABLE_get (StringTable table, StringId id);
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns the block with all the texts of the table, one after
+ *				the other in handle order and each one ended with '\0'. The
+ *				block must not be modified and is only valid until the next
+ *				text is stored.
+ *
+ * @Parameters: (in)     table = the string table
+ *				(out)    bytes = number of bytes of the block
+ * @Return: The block with the texts
+ *
+ ****************************************************************************/
+const char* STRINGTABLE_block (StringTable table, long* bytes);
+
+
+/****************************************************************************
+ *
+ * @Objective: Creates a string table with the texts of a block returned by
+ *				STRINGTABLE_block, so that every text gets back the same
+ *				handle. The block is copied at once and only the slots are
+ *				computed again, there is no allocation for each text.
+ *			   If the table fails to get its memory, it will set the error
+ *				code to STRING_ERROR_MALLOC.
+ *
+ * @Parameters: (in)     block = texts ended with '\0', one after the other
+ *				(in)     bytes = number of bytes of the block
+ * @Return: A string table with the texts of the block
+ *
+ ****************************************************************************/
+StringTable STRINGTABLE_createFromBlock (const char* block, long bytes);
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns the number of different texts stored in the table.
+ *				Every handle is smaller than this number.
+ *
+ * @Parameters: (in)     table = the string table to check
+ * @Return: The number of texts in the table
+ *
+ ****************************************************************************/
+int		STRINGTABLE_size (StringTable table);
+
+
+/****************************************************************************
+ *
+ * @Objective: Returns the number of bytes of dynamic memory the table is
+ *				using (texts, handles and slots).
+ *
+ * @Parameters: (in)     table = the string table to check
+ * @Return: The number of bytes used by the table
+ *
+ ****************************************************************************/
+long	STRINGTABLE_memory (StringTable table);
+
+
+/****************************************************************************
+ *
+ * @Objective: Removes all the texts from the table and frees any dynamic
+ *				memory block the table was using. The table must be created
+ *				again before usage.
+ *
+ * @Parameters: (in/out) table = the string table to destroy.
+ * @Return: ---
+ *
+ ****************************************************************************/
+void	STRINGTABLE_destroy (StringTable* table);
+
+
+/****************************************************************************
+ *
+ * @Objective: This function returns the error code provided by the last
+ *				operation run. The operations that update the error code are:
+ *				Create, Intern, Find and Reserve.
+ *
+ * @Parameters: (in)     table = the string table to check.
+ * @Return: an error code from the list of constants defined.
+ *
+ ****************************************************************************/
+int		STRINGTABLE_getErrorCode (StringTable table);
+
+
+#endif
@@ -0,0 +1,399 @@
+/****************************************************************************
+ *
+ * @Objective: Tests of the LinkedList ADT at the boundaries of a list: the
+ *             operations of the iterators, LINKEDLIST_removeNode and
+ *             LINKEDLIST_appendList on the first element, after the last one
+ *             and on an empty list, and the local node pools. Every
+ *             check of the contents walks the list in both directions and
+ *             also checks the size and the tail (appending after it).
+ *
+ *             Usage: ./tests/linkedlist_test (returns 0 if all pass)
+ *
+ ****************************************************************************/
+
+#include <stdio.h>
+#include "linkedlist.h"
+
+// Number of checks that failed.
+static int failed = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			failed++; \
+		} \
+	} while (0)
+
+
+static Student student (int login) {
+	Student s;
+
+	s.name = login;
+	s.login = login;
+	return s;
+}
+
+/*
+ * Returns true (!0) if the list has exactly the n given logins, in order
+ *  from the first element and in reverse order from the last one, and its
+ *  size is n.
+ */
+static int contains (LinkedList list, const int logins[], int n) {
+	ListIterator iterator;
+	const Student* s;
+	int i = 0;
+	int correct = LINKEDLIST_size(list) == n;
+
+	LINKEDLIST_FOREACH_READ(list, iterator, s) {
+		correct = correct && i < n && s->login == logins[i];
+		i++;
+	}
+	correct = correct && i == n;
+
+	LINKEDLIST_FOREACH_REVERSE_READ(list, iterator, s) {
+		i--;
+		correct = correct && i >= 0 && s->login == logins[i];
+	}
+	return correct && 0 == i;
+}
+
+/*
+ * Returns true (!0) if the last element of the list is the given login,
+ *  checked by appending a marker after the tail and removing it.
+ */
+static int endsWith (LinkedList list, int login) {
+	ListIterator iterator;
+	const Student* s;
+	int previous = -1;
+
+	LINKEDLIST_append(list, student(-1));
+	LINKEDLIST_FOREACH_READ(list, iterator, s) {
+		if (-1 == s->login) {
+			break;
+		}
+		previous = s->login;
+	}
+	LINKEDLIST_iteratorRemove(&iterator);
+	return previous == login;
+}
+
+static LinkedList listOf (NodePool pool, const int logins[], int n) {
+	LinkedList list = LINKEDLIST_createWithPool(pool);
+	int i = 0;
+
+	for (i = 0; i < n; i++) {
+		LINKEDLIST_append(list, student(logins[i]));
+	}
+	return list;
+}
+
+
+static void testEmpty (NodePool pool) {
+	LinkedList list = LINKEDLIST_createWithPool(pool);
+	ListIterator iterator;
+
+	LINKEDLIST_iterate(list, &iterator);
+	CHECK(LINKEDLIST_iteratorIsAtEnd(&iterator));
+	CHECK(NULL == LINKEDLIST_iteratorPeek(&iterator));
+
+	// Nothing to remove.
+	LINKEDLIST_iteratorRemove(&iterator);
+	CHECK(LIST_ERROR_END == LINKEDLIST_getErrorCode(list));
+	CHECK(contains(list, NULL, 0));
+
+	// Insert in an empty list: the iterator stays after the last element.
+	LINKEDLIST_iteratorInsert(&iterator, student(1));
+	CHECK(LIST_NO_ERROR == LINKEDLIST_getErrorCode(list));
+	CHECK(LINKEDLIST_iteratorIsAtEnd(&iterator));
+	CHECK(contains(list, (int[]) {1}, 1));
+	CHECK(endsWith(list, 1));
+
+	LINKEDLIST_destroy(&list);
+}
+
+static void testInsert (NodePool pool) {
+	LinkedList list = listOf(pool, (int[]) {2, 3}, 2);
+	ListIterator iterator;
+
+	// At the head: the iterator stays on the old first element.
+	LINKEDLIST_iterate(list, &iterator);
+	LINKEDLIST_iteratorInsert(&iterator, student(1));
+	CHECK(2 == LINKEDLIST_iteratorPeek(&iterator)->login);
+	CHECK(contains(list, (int[]) {1, 2, 3}, 3));
+
+	// After the last element: it becomes the tail.
+	LINKEDLIST_iteratorNext(&iterator);
+	LINKEDLIST_iteratorNext(&iterator);
+	LINKEDLIST_iteratorInsert(&iterator, student(4));
+	CHECK(LINKEDLIST_iteratorIsAtEnd(&iterator));
+	CHECK(contains(list, (int[]) {1, 2, 3, 4}, 4));
+	CHECK(endsWith(list, 4));
+
+	LINKEDLIST_destroy(&list);
+}
+
+static void testRemove (NodePool pool) {
+	LinkedList list = listOf(pool, (int[]) {1, 2, 3}, 3);
+	ListIterator iterator;
+
+	// At the head: the iterator moves to the new first element.
+	LINKEDLIST_iterate(list, &iterator);
+	LINKEDLIST_iteratorRemove(&iterator);
+	CHECK(2 == LINKEDLIST_iteratorPeek(&iterator)->login);
+	CHECK(contains(list, (int[]) {2, 3}, 2));
+
+	// At the tail: the iterator ends after the last element.
+	LINKEDLIST_iteratorNext(&iterator);
+	LINKEDLIST_iteratorRemove(&iterator);
+	CHECK(LINKEDLIST_iteratorIsAtEnd(&iterator));
+	CHECK(contains(list, (int[]) {2}, 1));
+	CHECK(endsWith(list, 2));
+
+	// The only element: the list is empty and can be appended to.
+	LINKEDLIST_iterate(list, &iterator);
+	LINKEDLIST_iteratorRemove(&iterator);
+	CHECK(LINKEDLIST_isEmpty(list));
+	CHECK(contains(list, NULL, 0));
+	LINKEDLIST_append(list, student(5));
+	CHECK(contains(list, (int[]) {5}, 1));
+
+	// The POV right after the removed element goes back with the iterator
+	//  and stays on the same element.
+	LINKEDLIST_append(list, student(6));
+	LINKEDLIST_goToHead(list);
+	LINKEDLIST_next(list);
+	LINKEDLIST_iterate(list, &iterator);
+	LINKEDLIST_iteratorRemove(&iterator);
+	CHECK(6 == LINKEDLIST_peek(list)->login);
+	CHECK(contains(list, (int[]) {6}, 1));
+
+	LINKEDLIST_destroy(&list);
+}
+
+static void testRemoveNode (NodePool pool) {
+	LinkedList list = LINKEDLIST_createWithPool(pool);
+	ListNode nodes[3];
+	ListIterator iterator;
+
+	LINKEDLIST_appendMany(list, (Student[]) {student(1), student(2), student(3)}, 3, nodes);
+
+	// At the head, with the POV on it: the POV moves to the next element.
+	LINKEDLIST_goToHead(list);
+	LINKEDLIST_removeNode(list, nodes[0]);
+	CHECK(LIST_NO_ERROR == LINKEDLIST_getErrorCode(list));
+	CHECK(2 == LINKEDLIST_peek(list)->login);
+	CHECK(contains(list, (int[]) {2, 3}, 2));
+
+	// At the tail, with the POV right after it: the POV stays at the end.
+	LINKEDLIST_next(list);
+	LINKEDLIST_next(list);
+	LINKEDLIST_removeNode(list, nodes[2]);
+	CHECK(LINKEDLIST_isAtEnd(list));
+	CHECK(contains(list, (int[]) {2}, 1));
+	CHECK(endsWith(list, 2));
+
+	// A backward walk from after the last element reaches the new tail.
+	LINKEDLIST_iterate(list, &iterator);
+	LINKEDLIST_iteratorNext(&iterator);
+	LINKEDLIST_iteratorPrevious(&iterator);
+	CHECK(2 == LINKEDLIST_iteratorPeek(&iterator)->login);
+
+	// The only node: the list is empty and can be appended to.
+	LINKEDLIST_removeNode(list, nodes[1]);
+	CHECK(LINKEDLIST_isEmpty(list));
+	CHECK(LINKEDLIST_isAtEnd(list));
+	CHECK(contains(list, NULL, 0));
+	LINKEDLIST_iterateLast(list, &iterator);
+	CHECK(LINKEDLIST_iteratorIsAtEnd(&iterator));
+	LINKEDLIST_append(list, student(4));
+	CHECK(contains(list, (int[]) {4}, 1));
+
+	// No node to remove.
+	LINKEDLIST_removeNode(list, NULL);
+	CHECK(LIST_ERROR_END == LINKEDLIST_getErrorCode(list));
+	CHECK(contains(list, (int[]) {4}, 1));
+
+	LINKEDLIST_destroy(&list);
+}
+
+static void testSplice (NodePool pool) {
+	LinkedList src = listOf(pool, (int[]) {1, 2, 3}, 3);
+	LinkedList dst = LINKEDLIST_createWithPool(pool);
+	NodePool other_pool = LINKEDLIST_createPool();
+	LinkedList other = LINKEDLIST_createWithPool(other_pool);
+	ListIterator from, to;
+
+	// From the head of the source into an empty list.
+	LINKEDLIST_iterate(src, &from);
+	LINKEDLIST_iterate(dst, &to);
+	LINKEDLIST_iteratorSpliceTo(&from, &to);
+	CHECK(2 == LINKEDLIST_iteratorPeek(&from)->login);
+	CHECK(LINKEDLIST_iteratorIsAtEnd(&to));
+	CHECK(contains(src, (int[]) {2, 3}, 2));
+	CHECK(contains(dst, (int[]) {1}, 1));
+
+	// From the tail of the source to the head of the destination.
+	LINKEDLIST_iteratorNext(&from);
+	LINKEDLIST_iterate(dst, &to);
+	LINKEDLIST_iteratorSpliceTo(&from, &to);
+	CHECK(LINKEDLIST_iteratorIsAtEnd(&from));
+	CHECK(contains(src, (int[]) {2}, 1));
+	CHECK(contains(dst, (int[]) {3, 1}, 2));
+	CHECK(endsWith(src, 2));
+	CHECK(endsWith(dst, 1));
+
+	// The only element, after the tail of the destination.
+	LINKEDLIST_iterate(src, &from);
+	LINKEDLIST_iterate(dst, &to);
+	LINKEDLIST_iteratorNext(&to);
+	LINKEDLIST_iteratorNext(&to);
+	LINKEDLIST_iteratorSpliceTo(&from, &to);
+	CHECK(LINKEDLIST_isEmpty(src));
+	CHECK(contains(dst, (int[]) {3, 1, 2}, 3));
+	CHECK(endsWith(dst, 2));
+
+	// Nothing to splice from an empty list.
+	LINKEDLIST_iterate(src, &from);
+	LINKEDLIST_iteratorSpliceTo(&from, &to);
+	CHECK(LIST_ERROR_END == LINKEDLIST_getErrorCode(src));
+
+	// The lists must share the node pool.
+	LINKEDLIST_iterate(dst, &from);
+	LINKEDLIST_iterate(other, &to);
+	LINKEDLIST_iteratorSpliceTo(&from, &to);
+	CHECK(LIST_ERROR_POOL == LINKEDLIST_getErrorCode(dst));
+	CHECK(contains(dst, (int[]) {3, 1, 2}, 3));
+	CHECK(contains(other, NULL, 0));
+
+	LINKEDLIST_destroy(&src);
+	LINKEDLIST_destroy(&dst);
+	LINKEDLIST_destroy(&other);
+	LINKEDLIST_destroyPool(&other_pool);
+}
+
+static void testAppendList (NodePool pool) {
+	LinkedList dst = listOf(pool, (int[]) {1, 2}, 2);
+	LinkedList src = listOf(pool, (int[]) {3, 4}, 2);
+	LinkedList empty = LINKEDLIST_createWithPool(pool);
+
+	// The POV after the last element stays after the new last one.
+	LINKEDLIST_goToHead(dst);
+	LINKEDLIST_next(dst);
+	LINKEDLIST_next(dst);
+	LINKEDLIST_appendList(dst, src);
+	CHECK(LIST_NO_ERROR == LINKEDLIST_getErrorCode(src));
+	CHECK(LINKEDLIST_isAtEnd(dst));
+	CHECK(contains(dst, (int[]) {1, 2, 3, 4}, 4));
+	CHECK(endsWith(dst, 4));
+	CHECK(contains(src, NULL, 0));
+
+	// The emptied source can be used again.
+	LINKEDLIST_append(src, student(5));
+	CHECK(contains(src, (int[]) {5}, 1));
+	CHECK(endsWith(src, 5));
+
+	// Into an empty list: its POV was also after the last element.
+	LINKEDLIST_appendList(empty, dst);
+	CHECK(contains(empty, (int[]) {1, 2, 3, 4}, 4));
+	CHECK(LINKEDLIST_isAtEnd(empty));
+	CHECK(endsWith(empty, 4));
+
+	// An empty source does not change the destination.
+	LINKEDLIST_appendList(empty, dst);
+	CHECK(contains(empty, (int[]) {1, 2, 3, 4}, 4));
+	CHECK(contains(dst, NULL, 0));
+
+	LINKEDLIST_destroy(&dst);
+	LINKEDLIST_destroy(&src);
+	LINKEDLIST_destroy(&empty);
+}
+
+static void testLocalPool () {
+	NodePool shared = LINKEDLIST_createPool();
+	NodePool local = LINKEDLIST_createLocalPool(shared);
+	NodePool other_pool = LINKEDLIST_createPool();
+	LinkedList roster = listOf(shared, (int[]) {1}, 1);
+	LinkedList staging = listOf(local, (int[]) {2, 3}, 2);
+	LinkedList other = LINKEDLIST_createWithPool(other_pool);
+	ListIterator from, to;
+	int i = 0;
+
+	// More than a block of nodes, so the local pool carves several blocks.
+	for (i = 0; i < 2000; i++) {
+		LINKEDLIST_append(staging, student(4));
+	}
+	LINKEDLIST_iterateLast(staging, &from);
+	for (i = 0; i < 2000; i++) {
+		LINKEDLIST_iteratorRemove(&from);
+		LINKEDLIST_iteratorPrevious(&from);
+	}
+	CHECK(contains(staging, (int[]) {2, 3}, 2));
+
+	// Only a list of the shared pool takes the nodes of the local pool.
+	LINKEDLIST_appendList(other, staging);
+	CHECK(LIST_ERROR_POOL == LINKEDLIST_getErrorCode(staging));
+	CHECK(contains(staging, (int[]) {2, 3}, 2));
+	LINKEDLIST_appendList(roster, staging);
+	CHECK(LIST_NO_ERROR == LINKEDLIST_getErrorCode(staging));
+	CHECK(contains(roster, (int[]) {1, 2, 3}, 3));
+
+	// After the merge the nodes belong to the shared pool, which reuses the
+	//  free ones and frees them all.
+	LINKEDLIST_release(&staging);
+	LINKEDLIST_mergePool(&local);
+	CHECK(NULL == local);
+	LINKEDLIST_iterate(roster, &from);
+	LINKEDLIST_iteratorRemove(&from);
+	for (i = 0; i < 3000; i++) {
+		LINKEDLIST_append(roster, student(5));
+	}
+	LINKEDLIST_iterate(roster, &to);
+	CHECK(2 == LINKEDLIST_iteratorPeek(&to)->login);
+	CHECK(3002 == LINKEDLIST_size(roster));
+	CHECK(endsWith(roster, 5));
+
+	LINKEDLIST_release(&roster);
+	LINKEDLIST_destroy(&other);
+	LINKEDLIST_destroyPool(&shared);
+	LINKEDLIST_destroyPool(&other_pool);
+}
+
+static void testRelease () {
+	NodePool pool = LINKEDLIST_createPool();
+	LinkedList pooled = listOf(pool, (int[]) {1, 2, 3}, 3);
+	LinkedList alone = listOf(NULL, (int[]) {1, 2, 3}, 3);
+
+	// The nodes of the pooled list are freed with the pool.
+	LINKEDLIST_release(&pooled);
+	LINKEDLIST_release(&alone);
+	CHECK(NULL == pooled);
+	CHECK(NULL == alone);
+	LINKEDLIST_destroyPool(&pool);
+}
+
+
+int main () {
+	NodePool pool = LINKEDLIST_createPool();
+
+	// Every test runs with a node pool and with one malloc per node.
+	testEmpty(pool);
+	testEmpty(NULL);
+	testInsert(pool);
+	testInsert(NULL);
+	testRemove(pool);
+	testRemove(NULL);
+	testRemoveNode(pool);
+	testRemoveNode(NULL);
+	testSplice(pool);
+	testSplice(NULL);
+	testAppendList(pool);
+	testAppendList(NULL);
+	testLocalPool();
+
+	testRelease();
+	LINKEDLIST_destroyPool(&pool);
+
+	printf("linkedlist_test: %s\n", 0 == failed ? "all checks passed" : "FAILED");
+	return 0 == failed ? 0 : 1;
+}